@@ -1,9 +1,43 @@
 #include "tests/test_channel.hpp"
+#include "tests/test_queue.hpp"
 #include "tests/test_scopeguard.hpp"
 #include "tests/test_syncObj.hpp"
 #include "tests/test_asyncObj.hpp"
+#include "tests/allocation_counter.hpp"
 
+#include <cstdlib>
 #include <iostream>
+#include <new>
+
+// Count every heap allocation, for the tests that check for allocation-free paths.
+// GCC pairs the malloc() and free() below with the new and delete expressions they get inlined into, and warns.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size)
+{
+    conc_test::allocation_counter().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
 
 int main (int argc, char** argv)
 {
@@ -11,6 +45,10 @@ int main (int argc, char** argv)
     conc_test::channels::main();
     std::cout << std::endl;
 
+    std::cout << "[:: Performing queue test ::]" << std::endl;
+    conc_test::queues::main();
+    std::cout << std::endl;
+
     std::cout << "[:: Performing scope guard test ::]" << std::endl;
     conc_test::scope_guards::main();
     std::cout << std::endl;
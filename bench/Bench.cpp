@@ -0,0 +1,64 @@
+#include "bench/bench_async_object.hpp"
+#include "bench/bench_channel.hpp"
+#include "bench/bench_common.hpp"
+#include "bench/bench_cow.hpp"
+#include "bench/bench_latency.hpp"
+#include "bench/bench_queue.hpp"
+#include "bench/bench_sync_object.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Count every heap allocation, to report allocations per operation.
+// GCC pairs the malloc() and free() below with the new and delete expressions they get inlined into, and warns.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size)
+{
+    conc_bench::allocation_counter().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main (int argc, char** argv)
+{
+    conc_bench::options opts;
+    if (!opts.parse(argc, argv))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--format=table|csv|json] [--ops=N] [--threads=1,2,4] [--payloads=8,64,1024] [--filter=name]" << std::endl
+                  << "       Benchmarks: queue, channel, channel_roundtrip, sync_object, async_object, cow_ptr" << std::endl;
+        return 1;
+    }
+
+    conc_bench::reporter out(opts.format);
+    out.begin();
+    conc_bench::queues::main(opts, out);
+    conc_bench::channels::main(opts, out);
+    conc_bench::latency::main(opts, out);
+    conc_bench::sync_object::main(opts, out);
+    conc_bench::async_object::main(opts, out);
+    conc_bench::cow::main(opts, out);
+    out.end();
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+#ifndef __BENCH_ASYNC_OBJECT_HPP__
+#define __BENCH_ASYNC_OBJECT_HPP__
+
+#include "bench/bench_common.hpp"
+#include "concurrent/async_object.hpp"
+#include "concurrent/executor.hpp"
+#include "concurrent/future.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace conc_bench
+{
+    namespace async_object
+    {
+        /** \brief numThreads threads post a functor that modifies and copies out the protected value, opts.ops times in total.
+         *         Every thread keeps up to batchSize calls in flight before it waits for their results; batchSize 1 means
+         *         each call is awaited immediately. Latency is measured from posting a call to having its result.
+         */
+        struct calls
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+            std::size_t batchSize;
+            const char* variant;
+            concurrent::executor* pool;         /**< Executor to run the object on, or nullptr for a thread of its own */
+            std::size_t maxBatchSize;           /**< Maximum number of calls the object executes in one batch */
+
+            template<typename Msg>
+            void run()
+            {
+                std::unique_ptr<concurrent::async_object<Msg>> objPtr(this->pool ? new concurrent::async_object<Msg>(*this->pool)
+                                                                                  : new concurrent::async_object<Msg>());
+                concurrent::async_object<Msg>& obj = *objPtr;
+                obj.set_max_batch_size(this->maxBatchSize);
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                std::size_t batchSize = this->batchSize;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&obj, &latencies, perThread, batchSize, t]() -> void
+                    {
+                        std::vector<concurrent::future<Msg>> pending;
+                        std::vector<std::int64_t> postedAt;
+                        pending.reserve(batchSize);
+                        postedAt.reserve(batchSize);
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            postedAt.push_back(now_ns());
+                            pending.push_back(obj <= [](Msg& m) -> Msg { ++m.stamp; return m; });
+                            if (pending.size() == batchSize || i + 1 == perThread)
+                            {
+                                for (std::size_t j = 0; j < pending.size(); ++j)
+                                {
+                                    pending[j].get();
+                                    latencies.record(t, now_ns() - postedAt[j]);
+                                }
+                                pending.clear();
+                                postedAt.clear();
+                            }
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "async_object";
+                res.variant = this->variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        /** \brief numThreads threads post opts.ops fire-and-forget mutations in total, then wait for all of them to be
+         *         executed. No latency is recorded, since posts have no result.
+         */
+        struct posts
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+            const char* variant;
+            concurrent::executor* pool;
+
+            template<typename Msg>
+            void run()
+            {
+                std::unique_ptr<concurrent::async_object<Msg>> objPtr(this->pool ? new concurrent::async_object<Msg>(*this->pool)
+                                                                                  : new concurrent::async_object<Msg>());
+                concurrent::async_object<Msg>& obj = *objPtr;
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&obj, perThread]() -> void
+                    {
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            obj.post([](Msg& m) -> void { ++m.stamp; });
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                (obj <= [](Msg&) -> void {}).get();
+                result res;
+                res.benchmark = "async_object";
+                res.variant = this->variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                this->out.add(res);
+            }
+        };
+
+        /** \brief numThreads threads flood the object with fire-and-forget posts, keeping a backlog of about backlog_depth
+         *         functors queued, while another thread sends opts.ops / 1000 (at least 100) control calls in the given lane and
+         *         waits for each of them. Only the control calls are timed; their latency shows how long they wait behind the
+         *         backlog.
+         */
+        struct control_calls
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+            concurrent::priority lane;
+            const char* variant;
+            concurrent::executor* pool;
+
+            static const std::uint64_t backlog_depth = 1000;
+
+            template<typename Msg>
+            void run()
+            {
+                std::unique_ptr<concurrent::async_object<Msg>> objPtr(this->pool ? new concurrent::async_object<Msg>(*this->pool)
+                                                                                  : new concurrent::async_object<Msg>());
+                concurrent::async_object<Msg>& obj = *objPtr;
+                std::uint64_t numCalls = this->opts.ops / 1000 > 100 ? this->opts.ops / 1000 : 100;
+                latency_recorder latencies(1, numCalls);
+                std::atomic<std::uint64_t> posted(0);
+                std::atomic<std::uint64_t> executed(0);
+                std::atomic<bool> flooding(true);
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&obj, &flooding, &posted, &executed]() -> void
+                    {
+                        while (flooding.load(std::memory_order_relaxed))
+                        {
+                            std::uint64_t done = executed.load(std::memory_order_relaxed); // Before posted, which never falls behind it.
+                            if (posted.load(std::memory_order_relaxed) - done >= backlog_depth)
+                            {
+                                std::this_thread::yield();
+                                continue;
+                            }
+                            posted.fetch_add(1, std::memory_order_relaxed);
+                            obj.post([&executed](Msg& m) -> void { ++m.stamp; executed.fetch_add(1, std::memory_order_relaxed); });
+                        }
+                    });
+                }
+                while (posted.load(std::memory_order_relaxed) < backlog_depth)
+                {
+                    std::this_thread::yield();  // Let the backlog build up first.
+                }
+                run_timer timer;
+                for (std::uint64_t i = 0; i < numCalls; ++i)
+                {
+                    std::int64_t sentAt = now_ns();
+                    obj.call(this->lane, [](Msg& m) -> std::uint64_t { return m.stamp; }).get();
+                    latencies.record(0, now_ns() - sentAt);
+                }
+                result res;
+                timer.finish(res, numCalls);
+                flooding.store(false);
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                (obj <= [](Msg&) -> void {}).get();
+                res.benchmark = "async_object_control";
+                res.variant = this->variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        /** \brief Constructs opts.ops / 100 objects, sends one call to each and destroys them again. Latency is the time per
+         *         object, which shows the cost of starting a thread per object compared to a strand on an executor.
+         */
+        struct lifecycle
+        {
+            const options& opts;
+            reporter& out;
+            const char* variant;
+            concurrent::executor* pool;
+
+            template<typename Msg>
+            void run()
+            {
+                std::uint64_t numObjects = this->opts.ops / 100 > 0 ? this->opts.ops / 100 : 1;
+                std::vector<std::unique_ptr<concurrent::async_object<Msg>>> objects;
+                objects.reserve(numObjects);
+                run_timer timer;
+                for (std::uint64_t i = 0; i < numObjects; ++i)
+                {
+                    objects.emplace_back(this->pool ? new concurrent::async_object<Msg>(*this->pool) : new concurrent::async_object<Msg>());
+                    *objects.back() <= [](Msg& m) -> void { ++m.stamp; };
+                }
+                objects.clear();
+                result res;
+                res.benchmark = "async_object_lifecycle";
+                res.variant = this->variant;
+                res.threads = 1;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, numObjects);
+                res.p50_ns = res.p99_ns = res.p999_ns = res.seconds * 1e9 / numObjects;
+                res.latency_samples = numObjects;
+                this->out.add(res);
+            }
+        };
+
+        void main(const options& opts, reporter& out)
+        {
+            if (!opts.selected("async_object"))
+            {
+                return;
+            }
+            concurrent::executor pool;
+            for (unsigned numThreads : opts.thread_counts)
+            {
+                calls waiting = { opts, out, numThreads, 1, "thread/call-and-wait", nullptr, 64 };
+                for_each_payload(opts, waiting);
+                calls pipelined = { opts, out, numThreads, 64, "thread/pipelined/64", nullptr, 64 };
+                for_each_payload(opts, pipelined);
+                calls unbatched = { opts, out, numThreads, 64, "thread/pipelined/64 unbatched", nullptr, 1 };
+                for_each_payload(opts, unbatched);
+                posts fireAndForget = { opts, out, numThreads, "thread/post", nullptr };
+                for_each_payload(opts, fireAndForget);
+                calls poolWaiting = { opts, out, numThreads, 1, "executor/call-and-wait", &pool, 64 };
+                for_each_payload(opts, poolWaiting);
+                calls poolPipelined = { opts, out, numThreads, 64, "executor/pipelined/64", &pool, 64 };
+                for_each_payload(opts, poolPipelined);
+                calls poolUnbatched = { opts, out, numThreads, 64, "executor/pipelined/64 unbatched", &pool, 1 };
+                for_each_payload(opts, poolUnbatched);
+                posts poolFireAndForget = { opts, out, numThreads, "executor/post", &pool };
+                for_each_payload(opts, poolFireAndForget);
+                control_calls bulkControl = { opts, out, numThreads, concurrent::priority::bulk, "thread/bulk lane", nullptr };
+                for_each_payload(opts, bulkControl);
+                control_calls urgentControl = { opts, out, numThreads, concurrent::priority::urgent, "thread/urgent lane", nullptr };
+                for_each_payload(opts, urgentControl);
+                control_calls poolBulkControl = { opts, out, numThreads, concurrent::priority::bulk, "executor/bulk lane", &pool };
+                for_each_payload(opts, poolBulkControl);
+                control_calls poolUrgentControl = { opts, out, numThreads, concurrent::priority::urgent, "executor/urgent lane", &pool };
+                for_each_payload(opts, poolUrgentControl);
+            }
+            lifecycle threadPerObject = { opts, out, "thread", nullptr };
+            for_each_payload(opts, threadPerObject);
+            lifecycle strands = { opts, out, "executor", &pool };
+            for_each_payload(opts, strands);
+        }
+    }
+}
+
+#endif // __BENCH_ASYNC_OBJECT_HPP__
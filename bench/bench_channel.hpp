@@ -0,0 +1,143 @@
+#ifndef __BENCH_CHANNEL_HPP__
+#define __BENCH_CHANNEL_HPP__
+
+#include "bench/bench_common.hpp"
+#include "concurrent/channel/channel.hpp"
+#include "concurrent/storage/ring_buffer.hpp"
+#include "concurrent/lockfree/mpmc_ring.hpp"
+#include "concurrent/lockfree/spsc_ring.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace conc_bench
+{
+    namespace channels
+    {
+        const std::size_t capacity = 1024;
+
+        struct mutex_std_queue
+        {
+            static const char* name() { return "mutex/std::queue"; }
+            template<typename Msg> using type = concurrent::channel<Msg>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(); }
+        };
+
+        struct mutex_ring_buffer
+        {
+            static const char* name() { return "mutex/ring_buffer"; }
+            template<typename Msg> using type = concurrent::channel<Msg, concurrent::ring_buffer>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(capacity); }
+        };
+
+        struct lockfree_mpmc
+        {
+            static const char* name() { return "lock-free/mpmc"; }
+            template<typename Msg> using type = concurrent::channel<Msg, concurrent::mpmc_ring>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(capacity); }
+        };
+
+        struct waitfree_spsc
+        {
+            static const char* name() { return "wait-free/spsc"; }
+            template<typename Msg> using type = concurrent::channel<Msg, concurrent::spsc_ring>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(capacity); }
+        };
+
+        struct chan_wrapper
+        {
+            static const char* name() { return "chan/std::queue"; }
+            template<typename Msg> using type = concurrent::chan<Msg>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(); }
+        };
+
+        /** \brief Sends opts.ops messages through a channel, using numThreads senders and as many receivers.
+         *         Latency is measured from sending to receiving every message.
+         */
+        template<typename Variant>
+        struct throughput
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+
+            template<typename Msg>
+            void run()
+            {
+                std::unique_ptr<typename Variant::template type<Msg>> ch(Variant::template create<Msg>());
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(2 * this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&ch, perThread, t]() -> void
+                    {
+                        pin_to_core(2 * t);
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            *ch << Msg(now_ns());
+                        }
+                    });
+                    threads.emplace_back([&ch, &latencies, perThread, t]() -> void
+                    {
+                        pin_to_core(2 * t + 1);
+                        Msg msg;
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            *ch >> msg;
+                            latencies.record(t, now_ns() - msg.stamp);
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "channel";
+                res.variant = Variant::name();
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        /** \brief Runs the variant for all selected thread counts.
+         *
+         * \param maxThreads unsigned Largest number of senders (and receivers) the variant supports.
+         */
+        template<typename Variant>
+        void run_variant(const options& opts, reporter& out, unsigned maxThreads = static_cast<unsigned>(-1))
+        {
+            for (unsigned numThreads : opts.thread_counts)
+            {
+                if (numThreads <= maxThreads)
+                {
+                    throughput<Variant> bench = { opts, out, numThreads };
+                    for_each_payload(opts, bench);
+                }
+            }
+        }
+
+        void main(const options& opts, reporter& out)
+        {
+            if (!opts.selected("channel"))
+            {
+                return;
+            }
+            run_variant<mutex_std_queue>(opts, out);
+            run_variant<mutex_ring_buffer>(opts, out);
+            run_variant<lockfree_mpmc>(opts, out);
+            run_variant<waitfree_spsc>(opts, out, 1);
+            run_variant<chan_wrapper>(opts, out);
+        }
+    }
+}
+
+#endif // __BENCH_CHANNEL_HPP__
@@ -0,0 +1,380 @@
+#ifndef __BENCH_COMMON_HPP__
+#define __BENCH_COMMON_HPP__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace conc_bench
+{
+    /** \brief Number of heap allocations performed by the process so far. Bench.cpp replaces the global operator new
+     *         to count them.
+     */
+    inline std::atomic<std::uint64_t>& allocation_counter()
+    {
+        static std::atomic<std::uint64_t> counter(0);
+        return counter;
+    }
+
+    inline std::int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** \brief Pins the calling thread to the given core, if supported. Has no effect if there are not enough cores.
+     */
+    inline void pin_to_core(unsigned core)
+    {
+    #ifdef __linux__
+        if (core < std::thread::hardware_concurrency())
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+    #else
+        (void) core;
+    #endif
+    }
+
+    /** \brief Message of a given size. The first bytes carry the time it was sent at, to measure end-to-end latency.
+     */
+    template<std::size_t Size>
+    struct payload
+    {
+        static_assert( Size >= sizeof(std::int64_t), "Payload has to be able to carry a time stamp!" );
+
+        payload() : stamp(0) {}
+        explicit payload(std::int64_t sentAt) : stamp(sentAt) {}
+
+        std::int64_t stamp;
+        std::array<char, Size - sizeof(std::int64_t)> data;
+    };
+
+    /** \brief Smallest message, consisting of the time stamp only (std::array<char, 0> would still occupy a byte).
+     */
+    template<>
+    struct payload<sizeof(std::int64_t)>
+    {
+        payload() : stamp(0) {}
+        explicit payload(std::int64_t sentAt) : stamp(sentAt) {}
+
+        std::int64_t stamp;
+    };
+
+    /** \brief One line of output: a benchmark run with a fixed variant, thread count and payload size.
+     */
+    struct result
+    {
+        result() : threads(0), payload_bytes(0), ops(0), seconds(0.0), ops_per_sec(0.0), p50_ns(0.0), p99_ns(0.0), p999_ns(0.0),
+                   allocs_per_op(0.0), latency_samples(0) {}
+
+        std::string benchmark;          /**< What was measured, e.g. "queue" */
+        std::string variant;            /**< Implementation or mode, e.g. "lock-free/mpmc" */
+        unsigned threads;
+        std::size_t payload_bytes;
+        std::uint64_t ops;
+        double seconds;
+        double ops_per_sec;
+        double p50_ns;
+        double p99_ns;
+        double p999_ns;
+        double allocs_per_op;
+        std::uint64_t latency_samples;  /**< Samples behind the percentiles; 0 if latency was not measured, which prints them as n/a */
+    };
+
+    /** \brief Collects latency samples of several threads. Every thread records into its own vector, which is reserved
+     *         up-front, so recording neither allocates nor synchronizes.
+     */
+    class latency_recorder
+    {
+        public:
+            latency_recorder(unsigned numThreads, std::uint64_t samplesPerThread) : __samples(numThreads)
+            {
+                for (auto& samples : this->__samples)
+                {
+                    samples.reserve(samplesPerThread);
+                }
+            }
+
+            void record(unsigned thread, std::int64_t nanoseconds)
+            {
+                this->__samples[thread].push_back(nanoseconds);
+            }
+
+            /** \brief Merges all samples and computes the percentiles. May only be called after all threads finished.
+             */
+            void percentiles(result& res)
+            {
+                std::vector<std::int64_t> all;
+                for (auto& samples : this->__samples)
+                {
+                    all.insert(all.end(), samples.begin(), samples.end());
+                }
+                res.p50_ns = __percentile(all, 0.5);
+                res.p99_ns = __percentile(all, 0.99);
+                res.p999_ns = __percentile(all, 0.999);
+                res.latency_samples = all.size();
+            }
+
+        private:
+            std::vector<std::vector<std::int64_t>> __samples;
+
+            static double __percentile(std::vector<std::int64_t>& samples, double fraction)
+            {
+                if (samples.empty())
+                {
+                    return 0;
+                }
+                std::size_t index = static_cast<std::size_t>(fraction * (samples.size() - 1) + 0.5);
+                std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+                return static_cast<double>(samples[index]);
+            }
+    };
+
+    /** \brief Measures wall clock time and allocations between its construction and finish().
+     */
+    class run_timer
+    {
+        public:
+            run_timer() : __allocations(allocation_counter().load()), __start(std::chrono::steady_clock::now()) {}
+
+            void finish(result& res, std::uint64_t ops)
+            {
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - this->__start;
+                std::uint64_t allocations = allocation_counter().load() - this->__allocations;
+                res.ops = ops;
+                res.seconds = elapsed.count();
+                res.ops_per_sec = ops / elapsed.count();
+                res.allocs_per_op = ops > 0 ? static_cast<double>(allocations) / ops : 0.0;
+            }
+
+        private:
+            std::uint64_t __allocations;
+            std::chrono::steady_clock::time_point __start;
+    };
+
+    /** \brief Command line settings shared by all benchmarks.
+     */
+    struct options
+    {
+        enum format_type { table, csv, json };
+
+        options() : format(table), ops(200000), thread_counts({ 1, 2, 4 }), payload_sizes({ 8, 64, 1024 }) {}
+
+        format_type format;
+        std::uint64_t ops;                          /**< Operations per run, summed over all threads */
+        std::vector<unsigned> thread_counts;
+        std::vector<std::size_t> payload_sizes;     /**< Only sizes instantiated in for_each_payload() are supported */
+        std::string filter;                         /**< Only run benchmarks whose name contains it */
+
+        bool selected(const std::string& benchmark) const
+        {
+            return this->filter.empty() || benchmark.find(this->filter) != std::string::npos;
+        }
+
+        bool has_payload(std::size_t size) const
+        {
+            return std::find(this->payload_sizes.begin(), this->payload_sizes.end(), size) != this->payload_sizes.end();
+        }
+
+        /** \brief Parses --format=table|csv|json, --ops=N, --threads=1,2,4, --payloads=8,64,1024 and --filter=name.
+         *         A plain number is taken as --ops, for compatibility.
+         *
+         * \return bool "false" if an argument could not be parsed.
+         */
+        bool parse(int argc, char** argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string arg(argv[i]);
+                std::string value = arg.substr(arg.find('=') + 1);
+                if (arg.compare(0, 9, "--format=") == 0)
+                {
+                    if (value == "table") this->format = table;
+                    else if (value == "csv") this->format = csv;
+                    else if (value == "json") this->format = json;
+                    else return false;
+                }
+                else if (arg.compare(0, 6, "--ops=") == 0)
+                {
+                    this->ops = std::strtoull(value.c_str(), nullptr, 10);
+                }
+                else if (arg.compare(0, 10, "--threads=") == 0)
+                {
+                    this->thread_counts = __parse_list<unsigned>(value);
+                }
+                else if (arg.compare(0, 11, "--payloads=") == 0)
+                {
+                    this->payload_sizes = __parse_list<std::size_t>(value);
+                }
+                else if (arg.compare(0, 9, "--filter=") == 0)
+                {
+                    this->filter = value;
+                }
+                else if (!arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos)
+                {
+                    this->ops = std::strtoull(arg.c_str(), nullptr, 10);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return this->ops > 0 && !this->thread_counts.empty();
+        }
+
+        private:
+            template<typename N>
+            static std::vector<N> __parse_list(const std::string& value)
+            {
+                std::vector<N> list;
+                std::size_t pos = 0;
+                while (pos < value.size())
+                {
+                    std::size_t next = value.find(',', pos);
+                    if (next == std::string::npos)
+                    {
+                        next = value.size();
+                    }
+                    N n = static_cast<N>(std::strtoull(value.substr(pos, next - pos).c_str(), nullptr, 10));
+                    if (n > 0)
+                    {
+                        list.push_back(n);
+                    }
+                    pos = next + 1;
+                }
+                return list;
+            }
+    };
+
+    /** \brief Calls f.template run<payload<Size>>() for every supported payload size that was selected.
+     */
+    template<typename F>
+    void for_each_payload(const options& opts, F& f)
+    {
+        if (opts.has_payload(8)) f.template run< payload<8> >();
+        if (opts.has_payload(64)) f.template run< payload<64> >();
+        if (opts.has_payload(1024)) f.template run< payload<1024> >();
+    }
+
+    /** \brief Prints results either as human-readable table, as CSV or as JSON array. Results are written as soon as
+     *         they are available, so long runs show progress.
+     */
+    class reporter
+    {
+        public:
+            explicit reporter(options::format_type format, std::ostream& out = std::cout) : __format(format), __out(out), __count(0) {}
+
+            void begin()
+            {
+                if (this->__format == options::csv)
+                {
+                    this->__out << "benchmark,variant,threads,payload_bytes,ops,seconds,ops_per_sec,p50_ns,p99_ns,p999_ns,allocs_per_op" << std::endl;
+                }
+                else if (this->__format == options::json)
+                {
+                    this->__out << "[" << std::endl;
+                }
+                else
+                {
+                    this->__out << std::left << std::setw(24) << "benchmark" << std::setw(38) << "variant" << std::right
+                                << std::setw(8) << "threads" << std::setw(9) << "payload" << std::setw(14) << "ops/s"
+                                << std::setw(11) << "p50 ns" << std::setw(11) << "p99 ns" << std::setw(11) << "p999 ns"
+                                << std::setw(12) << "allocs/op" << std::endl;
+                }
+            }
+
+            void add(const result& res)
+            {
+                if (this->__format == options::csv)
+                {
+                    this->__out << res.benchmark << "," << res.variant << "," << res.threads << "," << res.payload_bytes << ","
+                                << res.ops << "," << res.seconds << "," << res.ops_per_sec << ",";
+                    if (res.latency_samples > 0)
+                    {
+                        this->__out << res.p50_ns << "," << res.p99_ns << "," << res.p999_ns << ",";
+                    }
+                    else
+                    {
+                        this->__out << ",,,";   // Not measured
+                    }
+                    this->__out << res.allocs_per_op << std::endl;
+                }
+                else if (this->__format == options::json)
+                {
+                    this->__out << (this->__count > 0 ? ",\n" : "")
+                                << "  {\"benchmark\": \"" << res.benchmark << "\", \"variant\": \"" << res.variant
+                                << "\", \"threads\": " << res.threads << ", \"payload_bytes\": " << res.payload_bytes
+                                << ", \"ops\": " << res.ops << ", \"seconds\": " << res.seconds
+                                << ", \"ops_per_sec\": " << res.ops_per_sec;
+                    this->__out << ", \"p50_ns\": ";
+                    __json_latency(res, res.p50_ns);
+                    this->__out << ", \"p99_ns\": ";
+                    __json_latency(res, res.p99_ns);
+                    this->__out << ", \"p999_ns\": ";
+                    __json_latency(res, res.p999_ns);
+                    this->__out << ", \"allocs_per_op\": " << res.allocs_per_op << "}";
+                }
+                else
+                {
+                    this->__out << std::left << std::setw(24) << res.benchmark << std::setw(38) << res.variant << std::right
+                                << std::setw(8) << res.threads << std::setw(9) << res.payload_bytes
+                                << std::fixed << std::setprecision(0) << std::setw(14) << res.ops_per_sec;
+                    if (res.latency_samples > 0)
+                    {
+                        this->__out << std::setw(11) << res.p50_ns << std::setw(11) << res.p99_ns << std::setw(11) << res.p999_ns;
+                    }
+                    else
+                    {
+                        this->__out << std::setw(11) << "n/a" << std::setw(11) << "n/a" << std::setw(11) << "n/a";
+                    }
+                    this->__out << std::setprecision(2) << std::setw(12) << res.allocs_per_op << std::endl;
+                    this->__out.unsetf(std::ios_base::floatfield);
+                }
+                ++this->__count;
+            }
+
+            void end()
+            {
+                if (this->__format == options::json)
+                {
+                    this->__out << (this->__count > 0 ? "\n" : "") << "]" << std::endl;
+                }
+            }
+
+        private:
+            options::format_type __format;
+            std::ostream& __out;
+            std::size_t __count;
+
+            void __json_latency(const result& res, double nanoseconds)
+            {
+                if (res.latency_samples > 0)
+                {
+                    this->__out << nanoseconds;
+                }
+                else
+                {
+                    this->__out << "null";
+                }
+            }
+    };
+}
+
+#endif // __BENCH_COMMON_HPP__
@@ -0,0 +1,88 @@
+#ifndef __BENCH_COW_HPP__
+#define __BENCH_COW_HPP__
+
+#include "bench/bench_common.hpp"
+#include "concurrent/cow/CoW.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace conc_bench
+{
+    namespace cow
+    {
+        /** \brief numThreads threads take copies of a shared cow::ptr and read through them; every writeEvery-th copy gets
+         *         modified, which clones the value. Latency is measured per copy-and-access.
+         */
+        struct copies
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+            std::uint64_t writeEvery;
+            const char* variant;
+
+            template<typename Msg>
+            void run()
+            {
+                const concurrent::cow::ptr<Msg> original(new Msg());
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                std::uint64_t writeEvery = this->writeEvery;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&original, &latencies, perThread, writeEvery, t]() -> void
+                    {
+                        std::int64_t sum = 0;
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            std::int64_t start = now_ns();
+                            concurrent::cow::ptr<Msg> copy(original);
+                            if (i % writeEvery == 0)
+                            {
+                                copy->stamp = static_cast<std::int64_t>(i); // Clones the shared value.
+                            }
+                            const concurrent::cow::ptr<Msg>& view = copy;
+                            sum += view->stamp;
+                            latencies.record(t, now_ns() - start);
+                        }
+                        (void) sum;
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "cow_ptr";
+                res.variant = this->variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        void main(const options& opts, reporter& out)
+        {
+            if (!opts.selected("cow_ptr"))
+            {
+                return;
+            }
+            for (unsigned numThreads : opts.thread_counts)
+            {
+                copies readMostly = { opts, out, numThreads, 16, "read-mostly (1/16 writes)" };
+                for_each_payload(opts, readMostly);
+                copies writeAlways = { opts, out, numThreads, 1, "write-always" };
+                for_each_payload(opts, writeAlways);
+            }
+        }
+    }
+}
+
+#endif // __BENCH_COW_HPP__
@@ -0,0 +1,95 @@
+#ifndef __BENCH_LATENCY_HPP__
+#define __BENCH_LATENCY_HPP__
+
+#include "bench/bench_channel.hpp"
+#include "bench/bench_common.hpp"
+#include "concurrent/wait_strategy.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace conc_bench
+{
+    namespace latency
+    {
+        /** \brief Bounces a message between two threads via two channels, so each round trip consists of two handoffs
+         *         to a thread that is already waiting. Reports the round trip time per wait strategy.
+         */
+        template<typename Variant>
+        struct round_trip
+        {
+            const options& opts;
+            reporter& out;
+            const char* strategyName;
+            concurrent::wait_strategy strategy;
+
+            template<typename Msg>
+            void run()
+            {
+                std::unique_ptr<typename Variant::template type<Msg>> ping(Variant::template create<Msg>());
+                std::unique_ptr<typename Variant::template type<Msg>> pong(Variant::template create<Msg>());
+                ping->set_wait_strategy(this->strategy);
+                pong->set_wait_strategy(this->strategy);
+                std::uint64_t numRoundTrips = this->opts.ops / 10 > 0 ? this->opts.ops / 10 : 1;
+                latency_recorder latencies(1, numRoundTrips);
+                run_timer timer;
+                std::thread echo([&ping, &pong, numRoundTrips]() -> void
+                {
+                    pin_to_core(1);
+                    Msg msg;
+                    for (std::uint64_t i = 0; i < numRoundTrips; ++i)
+                    {
+                        *ping >> msg;
+                        *pong << msg;
+                    }
+                });
+                std::thread initiator([&ping, &pong, &latencies, numRoundTrips]() -> void
+                {
+                    pin_to_core(0);
+                    Msg msg;
+                    for (std::uint64_t i = 0; i < numRoundTrips; ++i)
+                    {
+                        *ping << Msg(now_ns());
+                        *pong >> msg;
+                        latencies.record(0, now_ns() - msg.stamp);
+                    }
+                });
+                initiator.join();
+                echo.join();
+                result res;
+                res.benchmark = "channel_roundtrip";
+                res.variant = std::string(Variant::name()) + " " + this->strategyName;
+                res.threads = 2;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, numRoundTrips);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        template<typename Variant>
+        void run_variant(const options& opts, reporter& out)
+        {
+            round_trip<Variant> cpuFriendly = { opts, out, "cpu_friendly", concurrent::wait_strategy::cpu_friendly() };
+            for_each_payload(opts, cpuFriendly);
+            round_trip<Variant> balanced = { opts, out, "balanced", concurrent::wait_strategy::balanced() };
+            for_each_payload(opts, balanced);
+            round_trip<Variant> latencyOptimized = { opts, out, "latency_optimized", concurrent::wait_strategy::latency_optimized() };
+            for_each_payload(opts, latencyOptimized);
+        }
+
+        void main(const options& opts, reporter& out)
+        {
+            if (!opts.selected("channel_roundtrip"))
+            {
+                return;
+            }
+            run_variant<channels::mutex_ring_buffer>(opts, out);
+            run_variant<channels::lockfree_mpmc>(opts, out);
+        }
+    }
+}
+
+#endif // __BENCH_LATENCY_HPP__
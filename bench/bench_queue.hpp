@@ -0,0 +1,116 @@
+#ifndef __BENCH_QUEUE_HPP__
+#define __BENCH_QUEUE_HPP__
+
+#include "bench/bench_common.hpp"
+#include "concurrent/queue.hpp"
+#include "concurrent/storage/ring_buffer.hpp"
+#include "concurrent/lockfree/mpmc_ring.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace conc_bench
+{
+    namespace queues
+    {
+        const std::size_t capacity = 1024;
+
+        struct mutex_std_queue
+        {
+            static const char* name() { return "mutex/std::queue"; }
+            template<typename Msg> using type = concurrent::queue<Msg>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(); }
+        };
+
+        struct mutex_ring_buffer
+        {
+            static const char* name() { return "mutex/ring_buffer"; }
+            template<typename Msg> using type = concurrent::queue<Msg, concurrent::ring_buffer>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(capacity); }
+        };
+
+        struct lockfree_mpmc
+        {
+            static const char* name() { return "lock-free/mpmc"; }
+            template<typename Msg> using type = concurrent::queue<Msg, concurrent::mpmc_ring>;
+            template<typename Msg> static type<Msg>* create() { return new type<Msg>(capacity); }
+        };
+
+        /** \brief Pushes opts.ops messages through a queue, using numThreads producers and as many consumers.
+         *         Latency is measured from push to pop of every message.
+         */
+        template<typename Variant>
+        struct throughput
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+
+            template<typename Msg>
+            void run()
+            {
+                std::unique_ptr<typename Variant::template type<Msg>> q(Variant::template create<Msg>());
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(2 * this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&q, perThread]() -> void
+                    {
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            q->push(Msg(now_ns()));
+                        }
+                    });
+                    threads.emplace_back([&q, &latencies, perThread, t]() -> void
+                    {
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            Msg msg = q->pop();
+                            latencies.record(t, now_ns() - msg.stamp);
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "queue";
+                res.variant = Variant::name();
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        template<typename Variant>
+        void run_variant(const options& opts, reporter& out)
+        {
+            for (unsigned numThreads : opts.thread_counts)
+            {
+                throughput<Variant> bench = { opts, out, numThreads };
+                for_each_payload(opts, bench);
+            }
+        }
+
+        void main(const options& opts, reporter& out)
+        {
+            if (!opts.selected("queue"))
+            {
+                return;
+            }
+            run_variant<mutex_std_queue>(opts, out);
+            run_variant<mutex_ring_buffer>(opts, out);
+            run_variant<lockfree_mpmc>(opts, out);
+        }
+    }
+}
+
+#endif // __BENCH_QUEUE_HPP__
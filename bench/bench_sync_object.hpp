@@ -0,0 +1,219 @@
+#ifndef __BENCH_SYNC_OBJECT_HPP__
+#define __BENCH_SYNC_OBJECT_HPP__
+
+#include "bench/bench_common.hpp"
+#include "concurrent/reader_biased_lock.hpp"
+#include "concurrent/sharded_sync_object.hpp"
+#include "concurrent/sync_object.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<shared_mutex>)
+#include <shared_mutex>
+#endif
+#endif
+
+namespace conc_bench
+{
+    namespace sync_object
+    {
+        /** \brief numThreads threads apply a functor that modifies and copies out the protected value, opts.ops times in total.
+         *         Latency is measured per call, including waiting for the lock (or for the combiner, with flat_combining).
+         */
+        template<typename Lock>
+        struct calls
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+            const char* variant;
+
+            template<typename Msg>
+            void run()
+            {
+                concurrent::sync_object<Msg, Lock> obj;
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&obj, &latencies, perThread, t]() -> void
+                    {
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            std::int64_t start = now_ns();
+                            auto res = obj <= [](Msg& m) -> Msg { ++m.stamp; return m; };
+                            latencies.record(t, now_ns() - start);
+                            (void) res;
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "sync_object";
+                res.variant = this->variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        /** \brief Like calls, but 99 of 100 calls only read the protected value (taking a const reference), as lookup tables do.
+         *         With a lock that offers shared access, the readers run concurrently.
+         */
+        template<typename Lock>
+        struct mostly_reads
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+            const char* variant;
+
+            template<typename Msg>
+            void run()
+            {
+                concurrent::sync_object<Msg, Lock> obj;
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&obj, &latencies, perThread, t]() -> void
+                    {
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            std::int64_t start = now_ns();
+                            if (i % 100 == 0)
+                            {
+                                obj <= [](Msg& m) -> void { ++m.stamp; };
+                            }
+                            else
+                            {
+                                auto res = obj <= [](const Msg& m) -> Msg { return m; };
+                                (void) res;
+                            }
+                            latencies.record(t, now_ns() - start);
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "sync_object_reads";
+                res.variant = this->variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        /** \brief numThreads threads update entries of a map, each thread its own 1024 keys, opts.ops times in total; once with
+         *         the map in a single sync_object, once in a sharded_sync_object of 16 shards. The sharded one should scale with
+         *         the number of threads, the single one should not.
+         */
+        struct keyed_updates
+        {
+            const options& opts;
+            reporter& out;
+            unsigned numThreads;
+
+            static const int keys_per_thread = 1024;
+
+            template<typename Msg>
+            void run()
+            {
+                typedef std::unordered_map<int, Msg> map_type;
+                concurrent::sync_object<map_type> single;
+                this->__run<Msg>("sync_object", [&single](int key) -> void {
+                    single <= [key](map_type& m) -> void { ++m[key].stamp; };
+                });
+                concurrent::sharded_sync_object<map_type> sharded(16);
+                this->__run<Msg>("sharded-16", [&sharded](int key) -> void {
+                    sharded[key] <= [key](map_type& m) -> void { ++m[key].stamp; };
+                });
+            }
+
+            template<typename Msg, typename Update>
+            void __run(const char* variant, const Update& update)
+            {
+                std::uint64_t perThread = this->opts.ops / this->numThreads;
+                latency_recorder latencies(this->numThreads, perThread);
+                std::vector<std::thread> threads;
+                threads.reserve(this->numThreads);
+                run_timer timer;
+                for (unsigned t = 0; t < this->numThreads; ++t)
+                {
+                    threads.emplace_back([&update, &latencies, perThread, t]() -> void
+                    {
+                        for (std::uint64_t i = 0; i < perThread; ++i)
+                        {
+                            int key = static_cast<int>(t) * keys_per_thread + static_cast<int>(i % keys_per_thread);
+                            std::int64_t start = now_ns();
+                            update(key);
+                            latencies.record(t, now_ns() - start);
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                result res;
+                res.benchmark = "sync_object_keyed";
+                res.variant = variant;
+                res.threads = this->numThreads;
+                res.payload_bytes = sizeof(Msg);
+                timer.finish(res, perThread * this->numThreads);
+                latencies.percentiles(res);
+                this->out.add(res);
+            }
+        };
+
+        void main(const options& opts, reporter& out)
+        {
+            if (!opts.selected("sync_object"))
+            {
+                return;
+            }
+            for (unsigned numThreads : opts.thread_counts)
+            {
+                calls<std::mutex> mutexCalls = { opts, out, numThreads, "mutex" };
+                for_each_payload(opts, mutexCalls);
+                calls<concurrent::flat_combining> combinedCalls = { opts, out, numThreads, "flat-combining" };
+                for_each_payload(opts, combinedCalls);
+                mostly_reads<std::mutex> mutexReads = { opts, out, numThreads, "mutex" };
+                for_each_payload(opts, mutexReads);
+#if defined(__cpp_lib_shared_mutex)
+                mostly_reads<std::shared_mutex> sharedReads = { opts, out, numThreads, "std::shared_mutex" };
+                for_each_payload(opts, sharedReads);
+#endif
+                mostly_reads<concurrent::reader_biased_lock> biasedReads = { opts, out, numThreads, "reader-biased" };
+                for_each_payload(opts, biasedReads);
+                mostly_reads<concurrent::seqlock> seqlockReads = { opts, out, numThreads, "seqlock" };
+                for_each_payload(opts, seqlockReads);
+                keyed_updates keyed = { opts, out, numThreads };
+                for_each_payload(opts, keyed);
+            }
+        }
+    }
+}
+
+#endif // __BENCH_SYNC_OBJECT_HPP__
@@ -4,11 +4,23 @@
 #include <atomic>
 #include <exception>
 #include <functional>
-#include <future>
 #include <memory>
+#include <iterator>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "queue.hpp"
+#include "read_only.hpp"
+#include "coroutine.hpp"
+#include "executor.hpp"
+#include "future.hpp"
+#include "task.hpp"
+#include "internal/batch_counter.hpp"
+#include "internal/strand.hpp"
+#include "internal/task_monitor.hpp"
+#include "storage/priority_lanes.hpp"
 #include "util/detect.hpp"
 #include "util/member_swap.hpp"
 
@@ -31,6 +43,20 @@ namespace concurrent
      *         simple, since the destination did not do anything before. This is more complicated in case of move assignment. 
      *         Anyway, the current state of move support should be considered as EXPERIMENTAL - the current test-stage did not discover any issues, but since the execution order
      *         cannot be completely determined, it does not mean that there are none.
+     *         By default, every object runs its own worker thread. Constructed with an executor, it becomes a strand on that
+     *         executor instead: its functors are still executed one after another in the order they were sent, but on the
+     *         executor's worker threads, so any number of objects can share a few threads.
+     *         Either way, functors are executed in batches: all pending ones, up to a configurable maximum, are taken from the
+     *         queue at once and run back to back, which saves a lock acquisition (and possibly a wakeup) per functor under load.
+     *         Functors are queued in one of two lanes: calls that need to overtake a backlog of regular (bulk) work, like health
+     *         checks or cancellations, can be sent as urgent with call() or post(). Functors keep their order within a lane.
+     *         On an executor, read-only functors - those taking a const T&, or wrapped by concurrent::read_only() - that are
+     *         queued one after another run concurrently on several workers. They still wait for the functors sent before them,
+     *         and the ones sent after them still wait for them, so writers stay serialized and in order. This requires T to
+     *         allow concurrent const access, like the standard library's types do.
+     *         If CONCURRENT_INSTRUMENTATION is defined (consistently for the whole program), every object keeps track of its queue
+     *         depth and of how long its functors wait and run, see get_task_statistics(). Otherwise, none of this is compiled in.
+     *         With C++20 coroutines, the results can be co_await-ed instead of waited for (see concurrent/coroutine.hpp).
      *
      *  \param Data-type that should be covered by this class.
      */
@@ -38,11 +64,23 @@ namespace concurrent
     class async_object
     {
         public:
+            typedef T value_type;
+
             /** \brief Default c'tor. If T has a default c'tor or can be constructed by uniform initialization, there is no need to give a particular instance.
              *
              * \param t T Value to handle inside this class.
              */
-            async_object(T t = T{}) : __myT(t), __workerThread([=]() -> void { __done = false; while (!__done) { this->__innerqueue.pop()(); }}) // Little complicated, but that's the horror we face due to s.th. like a pop() ...
+            async_object(T t = T{}) : __myT(t), __maxBatchSize(internal::strand::default_max_batch_size), __workerThread(__start_worker())
+            {
+
+            }
+
+            /** \brief C'tor for an object that runs its functors on the given executor instead of a thread of its own.
+             *
+             * \param ex executor& Executor to run the functors on. It has to outlive this object.
+             * \param t T Value to handle inside this class.
+             */
+            explicit async_object(executor& ex, T t = T{}) : __myT(t), __maxBatchSize(internal::strand::default_max_batch_size), __strand(std::make_shared<internal::strand>(ex)), __workerThread(__start_worker())
             {
 
             }
@@ -52,8 +90,9 @@ namespace concurrent
              * \param rhs const async_object& Asynchronized object to copy from.
              * \note If this c'tor can be used depends on T having a copy-c'tor or not - you will get a compile-error if it does not!
              *       This c'tor will block until the rhs instance copied the requested value (i.e., it waits for the future value), so handle it with care!
+             *       If rhs runs on an executor, the copy runs on the same one.
              */
-            async_object(const async_object& rhs) : __workerThread([=]() -> void { __done = false; while (!__done) { this->__innerqueue.pop()(); }})
+            async_object(const async_object& rhs) : __maxBatchSize(internal::strand::default_max_batch_size), __strand(__strand_like(rhs)), __workerThread(__start_worker())
             {
                 static_assert( std::is_copy_constructible<T>::value, "T is not copy-constructible!" );
                 if (this != std::addressof(rhs))
@@ -64,7 +103,7 @@ namespace concurrent
                         // a simple assignment ( = ).
                         if_member_swap< detect::has_member_swap<T>::value, T >::exec(this->__myT, value);                               
                     });
-                    res.wait(); // Wait for stable state
+                    __await(res, rhs.__strand); // Wait for stable state
                     res.get(); // just to get the exception if one occurred!
                 }
             }
@@ -76,11 +115,19 @@ namespace concurrent
              *       This c'tor will block until the rhs instance moved the requested value (i.e., it waits for the future value), so handle it with care!
              *       The effect on rhs depends on the effect defined on its T value's move-c'tor!
              * \note Moving the rhs message queue is logically correct (to complete open requests, though), but currently EXPERIMENTAL. If you face any issues, remove the corresponding line!
+             *       If rhs runs on an executor, its open requests stay with it; the new object runs on the same executor and takes
+             *       over the value once they are completed.
              */
-            async_object(async_object&& rhs) : __workerThread([=]() -> void { __done = false; while (!__done) { this->__innerqueue.pop()(); }})
+            async_object(async_object&& rhs) : __maxBatchSize(internal::strand::default_max_batch_size), __strand(__strand_like(rhs)), __workerThread(__start_worker())
             {
                 static_assert( std::is_move_constructible<T>::value, "T is not move-constructible!" );
-                if (this != std::addressof(rhs))
+                if (this != std::addressof(rhs) && rhs.__strand)
+                {
+                    auto res = rhs <= ([&](T& value) -> void { this->__myT = std::move(value); });
+                    __await(res, rhs.__strand);
+                    res.get();
+                }
+                else if (this != std::addressof(rhs))
                 {
                     this->__innerqueue.swap(rhs.__innerqueue);
                     rhs.__innerqueue.push([&]() { rhs.__done = true; });
@@ -94,7 +141,16 @@ namespace concurrent
              */
             ~async_object() 
             {
-                this->__innerqueue.push([=]() { __done = true; });
+                if (this->__strand)
+                {
+                    // Wait until all functors sent so far are completed, in both lanes; afterwards, the strand may only be referenced by the executor.
+                    auto urgent = this->__make_ready(priority::urgent);
+                    auto bulk = this->__make_ready(priority::bulk);
+                    __await(urgent, this->__strand);
+                    __await(bulk, this->__strand);
+                    return;
+                }
+                this->__innerqueue.push([this]() { this->__done = true; });
                 try
                 {
                     this->__workerThread.join(); // [Note] We don't want any exception here. E.g., it may occur by joining an already finished thread.
@@ -121,7 +177,7 @@ namespace concurrent
                         // a simple assignment ( = ).
                         if_member_swap< detect::has_member_swap<T>::value, T >::exec(this->__myT, value);                               
                     });
-                    res.wait(); // Wait for stable state
+                    __await(res, rhs.__strand); // Wait for stable state
                     res.get(); // just to get the exception if one occurred!
                 }                
                 return *this;
@@ -135,11 +191,22 @@ namespace concurrent
              *       This assignment will block until the rhs instance moved the requested value (i.e., it waits for the future value), so handle it with care!
              *       The effect on rhs depends on the effect defined on its T value's move-assignment operator!
              * \note Moving the rhs message queue is logically correct (to complete open requests, though), but currently EXPERIMENTAL. If you face any issues, remove the corresponding line!
+             *       If one of the objects runs on an executor, the queues are not touched: the value is moved out of rhs once its open
+             *       requests are completed, and moved into this object once its own are.
              */
             async_object& operator=(async_object&& rhs)
             {
                 static_assert( std::is_move_assignable<T>::value, "T is not move-assignable!" );
-                if (this != std::addressof(rhs))
+                if (this != std::addressof(rhs) && (this->__strand || rhs.__strand))
+                {
+                    auto moved = rhs <= ([](T& value) -> T { return std::move(value); });
+                    __await(moved, rhs.__strand);
+                    T value = moved.get();
+                    auto res = *this <= ([&](T& mine) -> void { mine = std::move(value); });
+                    __await(res, this->__strand);
+                    res.get();
+                }
+                else if (this != std::addressof(rhs))
                 {
                     this->__innerqueue.swap(rhs.__innerqueue);
                     rhs.__innerqueue.push([&]() { rhs.__done = true; }); // [Note] We're not using the "<=" operator here, but the worker queue.
@@ -149,62 +216,310 @@ namespace concurrent
                 return *this;
             }
 
+            /** \brief Sets the maximum number of functors executed in one batch. Smaller batches bound the time other objects on
+             *         the same executor have to wait for their turn; 1 executes functors one by one. 0 is treated as 1.
+             *
+             * \param maxBatchSize std::size_t Maximum batch size; the default is 64.
+             * \return *this
+             */
+            async_object& set_max_batch_size(std::size_t maxBatchSize)
+            {
+                maxBatchSize = maxBatchSize > 0 ? maxBatchSize : 1;
+                this->__maxBatchSize.store(maxBatchSize, std::memory_order_relaxed);
+                if (this->__strand)
+                {
+                    this->__strand->set_max_batch_size(maxBatchSize);
+                }
+                return *this;
+            }
+
+            std::size_t get_max_batch_size() const
+            {
+                return this->__maxBatchSize.load(std::memory_order_relaxed);
+            }
+
+            /** \brief Returns how many batches were executed so far and how large they were.
+             */
+            batch_statistics get_batch_statistics() const
+            {
+                return this->__strand ? this->__strand->get_batch_statistics() : this->__batches.snapshot();
+            }
+
+            /** \brief Returns the instrumentation counters and histograms of the functors sent with operator<=, call() and post().
+             *
+             * \return task_statistics Snapshot; its "enabled" member is "false" (and all counters are zero) unless
+             *         CONCURRENT_INSTRUMENTATION is defined.
+             */
+            task_statistics get_task_statistics() const
+            {
+                return this->__monitor.snapshot();
+            }
+
+            /** \brief Sets the handler for exceptions thrown by functors sent with post(). The handler is installed right away, in
+             *         every lane, i.e. it applies to every exception raised after this call - including those of functors sent before
+             *         that had not run yet. It is called by the thread executing the functor; read-only functors running
+             *         concurrently may call it concurrently as well.
+             *
+             * \param handler std::function<void(std::exception_ptr)> Handler; an empty one drops exceptions (the default).
+             * \return *this
+             */
+            async_object& set_error_handler(std::function<void(std::exception_ptr)> handler)
+            {
+                std::shared_ptr<const std::function<void(std::exception_ptr)>> installed;
+                if (handler)
+                {
+                    installed = std::make_shared<const std::function<void(std::exception_ptr)>>(std::move(handler));
+                }
+                std::lock_guard<std::mutex> guard(this->__errorHandlerLock);
+                this->__errorHandler = std::move(installed);
+                return *this;
+            }
+
+            /** \brief Sends a functor for asynchronous execution without a way to get its result, which saves the promise and
+             *         future operator<= creates. Meant for pure mutations.
+             *
+             * \param f F Functor to execute. Its result, if any, is discarded; an exception is passed to the error handler.
+             */
+            template<typename F>
+            void post(F&& f) const
+            {
+                this->post(priority::bulk, std::forward<F>(f));
+            }
+
+            /** \brief Like post(f), but in the given lane.
+             *
+             * \param lane priority Lane to queue the functor in; urgent functors are executed before queued bulk ones.
+             * \param f F Functor to execute.
+             */
+            template<typename F>
+            void post(priority lane, F&& f) const
+            {
+                typedef typename std::decay<decltype(this->__monitor.wrap(std::forward<F>(f)))>::type functor_type;
+                this->__dispatch(posted<functor_type>{ this, this->__monitor.wrap(std::forward<F>(f)) }, lane, is_read_only<F, T>::value);
+            }
+
+            /** \brief Sends a functor for asynchronous execution in the given lane.
+             *
+             * \param lane priority Lane to queue the functor in. Urgent functors are executed before queued bulk ones, except that one
+             *        bulk functor gets its turn after every few urgent ones, so that bulk work cannot starve.
+             * \param f F Functor to execute.
+             * \return Anything that the functor returns, as a concurrent::future-value.
+             * \note An urgent functor may still have to wait for the batch that is being executed when it arrives; use a smaller
+             *       maximum batch size if that is too long.
+             */
+            template<typename F>
+            auto call(priority lane, F&& f) const -> concurrent::future<decltype(f(std::declval<T&>()))>
+            {
+                typedef decltype(f(__myT)) result_type;
+                concurrent::promise<result_type> promisedRes;
+                auto ret = promisedRes.get_future();
+
+                // The monitor wraps the functor only, so it is done with the execution before the promise is fulfilled.
+                typedef typename std::decay<decltype(this->__monitor.wrap(std::forward<F>(f)))>::type functor_type;
+                this->__dispatch(invocation<functor_type, result_type>{ this, std::move(promisedRes), this->__monitor.wrap(std::forward<F>(f)) },
+                                 lane, is_read_only<F, T>::value);
+                return ret;
+            }
+
             /** \brief Operator-function to post a functor that should be executed asynchronously using the internally stored object. 
              *
              * \param f F Functor to execute.
-             * \return Anything that the functor returns, as a std::future-value.
+             * \return Anything that the functor returns, as a concurrent::future-value. It converts to a std::future if required.
              * \note This function will not block, if you need the result to go on, you will have to wait on the future-value!
+             * \note Posting does not allocate in steady state: the functor travels inside a concurrent::task, and the state shared by
+             *       promise and future is taken from the internal block pools.
+             * \note The functor is queued in the bulk lane; see call() for urgent ones.
              */
             template<typename F>
-            auto operator <= (F&& f) const -> std::future<decltype(f(__myT))>
+            auto operator <= (F&& f) const -> concurrent::future<decltype(f(std::declval<T&>()))>
             {              
-                auto promisedRes = std::make_shared< std::promise<decltype(f(__myT))> >();
-                auto ret = promisedRes->get_future();
+                return this->call(priority::bulk, std::forward<F>(f));
+            }
+
+
+        private:             
+            mutable T __myT;                                                           /**< Value that should be modifiable through any executed functor */
+            mutable concurrent::queue<task, priority_lanes, std::deque<task, internal::pool_allocator<task>>> __innerqueue; /**< Internally synchronized queue */
+            std::atomic_bool __done;                                                   /**< Indicator for the thread to run out */
+            std::atomic<std::size_t> __maxBatchSize;                                   /**< Maximum number of functors the worker thread takes at once */
+            internal::batch_counter __batches;                                         /**< Batches of the worker thread */
+            std::shared_ptr<const std::function<void(std::exception_ptr)>> __errorHandler; /**< Handler for exceptions of posted functors; replaced as a whole */
+            mutable std::mutex __errorHandlerLock;                                     /**< Guards __errorHandler; exceptions are rare enough for a lock */
+            mutable internal::task_monitor __monitor;                                  /**< Instrumentation; empty unless CONCURRENT_INSTRUMENTATION is defined */
+            std::shared_ptr<internal::strand> __strand;                                /**< Strand on an executor; if set, there is no worker thread */
+            std::thread __workerThread;                                                /**< Worker thread */
 
-                this->__innerqueue.push([=]() -> void { 
+            /** \brief Starts the worker thread, unless the object runs on an executor.
+             */
+            std::thread __start_worker()
+            {
+                if (this->__strand)
+                {
+                    return std::thread();
+                }
+                return std::thread([this]() -> void { this->__done = false; this->__work(); });
+            }
+
+            /** \brief Worker loop: takes all pending functors up to the maximum batch size in one go and runs them.
+             */
+            void __work()
+            {
+                std::vector<task> batch;
+                while (!this->__done)
+                {
+                    std::size_t maxBatchSize = this->__maxBatchSize.load(std::memory_order_relaxed);
+                    batch.reserve(maxBatchSize);
+                    this->__batches.record(this->__innerqueue.pop_bulk(std::back_inserter(batch), maxBatchSize));
+                    for (auto& t : batch)
+                    {
+                        t();
+                    }
+                    batch.clear();
+                }
+                // Bulk work gets a turn after a streak of urgent functors, so urgent ones may still be queued behind the stop request.
+                this->__innerqueue.drain_into(batch);
+                for (auto& t : batch)
+                {
+                    t();
+                }
+            }
+
+            static std::shared_ptr<internal::strand> __strand_like(const async_object& rhs)
+            {
+                return rhs.__strand ? std::make_shared<internal::strand>(rhs.__strand->get_executor()) : nullptr;
+            }
+
+            /** \brief Hands a task to the worker thread or the strand. Only the strand runs read-only (shared) tasks concurrently.
+             */
+            void __dispatch(task t, priority lane = priority::bulk, bool shared = false) const
+            {
+                if (this->__strand)
+                {
+                    this->__strand->post(std::move(t), lane, shared);
+                }
+                else
+                {
+                    this->__innerqueue.emplace(lane, std::move(t));
+                }
+            }
+
+            /** \brief Task that applies a functor to the value and passes its result to the promise.
+             *
+             * \param F Type of the functor.
+             * \param R Return-type of the functor.
+             */
+            template<typename F, typename R>
+            struct invocation
+            {
+                const async_object* self;
+                concurrent::promise<R> promise;
+                F f;
+
+                void operator()()
+                {
                     try
                     {
-                        this->__set_value(*promisedRes, f);
+                        this->self->__set_value(this->promise, this->f);
                     }
                     catch (...)
                     {
-                        promisedRes->set_exception(std::make_exception_ptr("Uh oh..."));
+                        this->promise.set_exception(std::current_exception());
                     }
-                });                
-                return ret;
+                }
+            };
+
+            /** \brief Task that applies a functor sent by post() to the value.
+             *
+             * \param F Type of the functor.
+             */
+            template<typename F>
+            struct posted
+            {
+                const async_object* self;
+                F f;
+
+                void operator()()
+                {
+                    try
+                    {
+                        this->f(this->self->__myT);
+                    }
+                    catch (...)
+                    {
+                        this->self->__handle_error(std::current_exception());
+                    }
+                }
+            };
+
+            void __handle_error(std::exception_ptr e) const
+            {
+                std::shared_ptr<const std::function<void(std::exception_ptr)>> handler;
+                {
+                    std::lock_guard<std::mutex> guard(this->__errorHandlerLock);
+                    handler = this->__errorHandler;
+                }
+                if (handler)
+                {
+                    try
+                    {
+                        (*handler)(e);
+                    }
+                    catch (...) {} // [Note] Nothing left to report to; the worker has to go on.
+                }
             }
 
+            /** \brief Returns a future that becomes ready once all functors sent before to the given lane are completed.
+             */
+            concurrent::future<void> __make_ready(priority lane) const
+            {
+                return this->call(lane, [](T&) -> void {});
+            }
 
-        private:             
-            mutable T __myT;                                                           /**< Value that should be modifiable through any executed functor */
-            mutable concurrent::queue<std::function<void()>> __innerqueue;             /**< Internally synchronized queue */
-            std::atomic_bool __done;                                                   /**< Indicator for the thread to run out */
-            std::thread __workerThread;                                                /**< Worker thread */
+            /** \brief Waits for a future that is fulfilled by the given strand (if any). If the calling thread is a worker of
+             *         the strand's executor, it keeps executing other tasks meanwhile, since the one it waits for might be queued
+             *         behind it - blocking would deadlock a single-threaded executor.
+             */
+            template<typename R>
+            static void __await(concurrent::future<R>& f, const std::shared_ptr<internal::strand>& s)
+            {
+                if (!s || !s->get_executor().in_worker_thread())
+                {
+                    f.wait();
+                    return;
+                }
+                while (!f.is_ready())
+                {
+                    if (!s->get_executor().try_run_one())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
             
             /** \brief Helper function that sets the value resulting from a functor if that result is not void.
-             *         Separation is required due to std::future::set_value, which does not take a parameter when the result should be void.  
+             *         Separation is required due to promise::set_value, which does not take a parameter when the result should be void.  
              *
-             * \param Fut Type that is handled inside the given std::promise, i.e. the return-type of the functor.
+             * \param Fut Type that is handled inside the given promise, i.e. the return-type of the functor.
              * \param F Type of the functor.
-             * \param p std::promise<Fut>& Promise-value to write the result to; the result will be accessible to the future-value.
+             * \param p concurrent::promise<Fut>& Promise-value to write the result to; the result will be accessible to the future-value.
              * \param f F& Functor to apply on the local T instance.
              *
              */
             template<typename Fut, typename F>
-            void __set_value(std::promise<Fut>& p, F& f) const 
+            void __set_value(concurrent::promise<Fut>& p, F& f) const 
             {
                 p.set_value(f(this->__myT));
             }
 
             /** \brief Helper function that sets the value resulting from a functor if that result is void.
-             *         Separation is required due to std::future::set_value, which does not take a parameter when the result should be void. 
+             *         Separation is required due to promise::set_value, which does not take a parameter when the result should be void. 
              *
              * \param F Type of the functor.
-             * \param p std::promise<void>& Promise-value to signal to.
+             * \param p concurrent::promise<void>& Promise-value to signal to.
              * \param f F& Functor to apply on the local T instance.
              */
             template<typename F>
-            void __set_value(std::promise<void>& p, F& f) const 
+            void __set_value(concurrent::promise<void>& p, F& f) const 
             {
                 f(this->__myT);
                 p.set_value();
@@ -1,17 +1,30 @@
 #ifndef CHANNEL_HPP
 #define CHANNEL_HPP
 
-#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <type_traits>
 
+#include "concurrent/channel/channel_status.hpp"
+#include "concurrent/channel/ring_channel.hpp"
+#include "concurrent/internal/parking_condition.hpp"
+#include "concurrent/internal/select_waiter.hpp"
+#include "concurrent/lockfree/mpmc_ring.hpp"
+#include "concurrent/lockfree/spsc_ring.hpp"
+#include "concurrent/wait_strategy.hpp"
+#include "util/detect.hpp"
+#include "util/member_full.hpp"
+
 namespace concurrent
 {
     /** \brief This is the basic channel class. It provides an internal message-queue and a stream-like
     *         message add/remove.
-    *  \param MsgType Type of the messages that are exchanged between the communications partners.
+    *  \param MsgType Type of the messages that are exchanged between the communications partners. Has to be
+    *         move-constructible; move-only types like std::unique_ptr are fine, since messages are moved on every hop.
     *  \param Storage Possibly custom container class. 
     *         Note that any container you use has to implement either the queue policy (here: push(T),
     *         pop(), front(), empty() ) directly or has to adopt the queue internals, like shown in
@@ -19,15 +32,44 @@ namespace concurrent
     *         I.e., by default, deque and list are implementing this, like
     *         template < class T, class Container = std::deque<T> > class queue
     *         template < class T, class Container = std::list<T> > class queue .
-    *  \param OptArgs Optional arguments that are handled over to the storage class.
+    *         If the container offers a "bool full() const" member (like concurrent::ring_buffer does), it is considered to be
+    *         bounded: operator<< blocks until there is room for the message, and operator< fails instead of blocking.
+    *  \param OptArgs Optional arguments that are handled over to the storage class, e.g. a custom allocator.
+    *         See concurrent/storage/pool_resource.hpp for storage on top of std::pmr.
     */
     template<typename MsgType, template<typename, typename...> class Storage = std::queue, typename... OptArgs>
     class channel
     {
-        static_assert( std::is_copy_constructible<MsgType>::value, "The message type requires to be copy-constructible!" );
+        static_assert( std::is_move_constructible<MsgType>::value, "The message type requires to be move-constructible!" );
+
+        typedef Storage<MsgType, OptArgs...> storage_type;
+        static const bool is_bounded = detect::has_member_full<storage_type>::value;
 
         public:
-            channel(void) {}
+            typedef MsgType value_type;
+
+            channel(void) : __closed(false) {}
+
+            /** \brief C'tor for bounded storage, e.g. concurrent::ring_buffer.
+            *
+            * \param capacity std::size_t Maximum number of messages that may be queued at the same time.
+            */
+            explicit channel(std::size_t capacity) : __closed(false), __msgQueue(capacity) {}
+
+            /** \brief C'tor that hands an allocator over to the storage, e.g. a std::pmr::memory_resource* for pmr::deque_storage.
+            *
+            * \param alloc const Alloc& Allocator (or anything the storage's allocator can be constructed from).
+            */
+            template<typename Alloc>
+            channel(std::allocator_arg_t, const Alloc& alloc) : __closed(false), __msgQueue(alloc) {}
+
+            /** \brief C'tor for bounded storage that hands an allocator over to the storage, e.g. for pmr::ring_buffer.
+            *
+            * \param alloc const Alloc& Allocator (or anything the storage's allocator can be constructed from).
+            * \param capacity std::size_t Maximum number of messages that may be queued at the same time.
+            */
+            template<typename Alloc>
+            channel(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity) : __closed(false), __msgQueue(capacity, alloc) {}
             ~channel() {}
 
             /**
@@ -40,13 +82,15 @@ namespace concurrent
             * \param msg const MsgType& Message to be added to the queue.
             * \return void
             *
-            * \note Function blocks until thread-safe access to the queue is possible.
+            * \note Function blocks until thread-safe access to the queue is possible and, in case of bounded storage, there is room for the message.
+            * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
             */
             void operator<<(const MsgType& msg)
             {
                 std::unique_lock<std::mutex> lock(this->__accessMutex); // Since std::queue is not thread-safe, we need the lock here.
+                this->__wait_not_full(lock);
                 this->__msgQueue.push(msg);
-                this->__waitCondition.notify_one();
+                this->__notify_pushed(1);
             }
 
             /** \brief Stream-style function that adds a message to the message-queue. Message is taken as r-value,
@@ -55,13 +99,15 @@ namespace concurrent
             * \param msg MsgType&& Message to be added to the queue.
             * \return void
             *
-            * \note Function blocks until thread-safe access to the queue is possible.
+            * \note Function blocks until thread-safe access to the queue is possible and, in case of bounded storage, there is room for the message.
+            * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
             */
             void operator<<(MsgType&& msg)
             {
                 std::unique_lock<std::mutex> lock(this->__accessMutex);
-                this->__msgQueue.push(msg);
-                this->__waitCondition.notify_one();
+                this->__wait_not_full(lock);
+                this->__msgQueue.push(std::move(msg));
+                this->__notify_pushed(1);
             }
 
 
@@ -70,16 +116,22 @@ namespace concurrent
             * \param msg const MsgType& Message to be added to the queue.
             * \return bool "true" if the message could be added to the queue, false otherwise.
             *
-            * \note Function returns immediately, message is only added if the queue can be accessed without waiting.
+            * \note Function returns immediately, message is only added if the queue can be accessed without waiting and, in case of bounded storage, is not full.
+            *       Messages are never added to a closed channel.
             */
             bool operator<(const MsgType& msg)
             {
                 if (this->__accessMutex.try_lock())
                 {
-                    this->__msgQueue.push(msg);
-                    this->__waitCondition.notify_one(); // Notify next available thread.
+                    bool couldPutMessage = false;
+                    if (!this->__closed && !this->__full())
+                    {
+                        this->__msgQueue.push(msg);
+                        this->__notify_pushed(1); // Notify next available thread.
+                        couldPutMessage = true;
+                    }
                     this->__accessMutex.unlock();
-                    return true;
+                    return couldPutMessage;
                 }
                 else
                 {
@@ -93,16 +145,22 @@ namespace concurrent
             * \param msg const MsgType& Message to be added to the queue.
             * \return bool "true" if the message could be added to the queue, "false" otherwise.
             *
-            * \note Function returns immediately, message is only added if the queue can be accessed without waiting.
+            * \note Function returns immediately, message is only added if the queue can be accessed without waiting and, in case of bounded storage, is not full.
+            *       Messages are never added to a closed channel.
             */
             bool operator<(MsgType&& msg)
             {
                 if (this->__accessMutex.try_lock())
                 {
-                    this->__msgQueue.push(msg);
-                    this->__waitCondition.notify_one(); // Notify next available thread.
+                    bool couldPutMessage = false;
+                    if (!this->__closed && !this->__full())
+                    {
+                        this->__msgQueue.push(std::move(msg));
+                        this->__notify_pushed(1); // Notify next available thread.
+                        couldPutMessage = true;
+                    }
                     this->__accessMutex.unlock();
-                    return true;
+                    return couldPutMessage;
                 }
                 else
                 {
@@ -110,6 +168,163 @@ namespace concurrent
                 }
             }
 
+            /** \brief Function that adds a message to the message-queue if that is possible without waiting for room.
+            *         In contrast to operator<, it waits for the lock, so it never fails due to contention.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \return channel_status success, not_ready if the (bounded) storage is full, or closed.
+            */
+            channel_status try_send(const MsgType& msg)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                channel_status status = this->__send_status();
+                if (status == channel_status::success)
+                {
+                    this->__msgQueue.push(msg);
+                    this->__notify_pushed(1);
+                }
+                return status;
+            }
+
+            /** \brief Function that adds a message to the message-queue if that is possible without waiting for room.
+            *         Message is taken as r-value; it is left untouched if it could not be added.
+            *
+            * \see try_send(const MsgType&)
+            */
+            channel_status try_send(MsgType&& msg)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                channel_status status = this->__send_status();
+                if (status == channel_status::success)
+                {
+                    this->__msgQueue.push(std::move(msg));
+                    this->__notify_pushed(1);
+                }
+                return status;
+            }
+
+            /** \brief Function that constructs a message in place at the end of the message-queue.
+            *
+            * \param args Args&&... Arguments that are forwarded to the constructor of MsgType.
+            * \return void
+            *
+            * \note Requires the storage to offer emplace(), like std::queue and concurrent::ring_buffer do. Function blocks like operator<<.
+            * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
+            */
+            template<typename... Args>
+            void emplace(Args&&... args)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__wait_not_full(lock);
+                this->__msgQueue.emplace(std::forward<Args>(args)...);
+                this->__notify_pushed(1);
+            }
+
+            /** \brief Function that adds a message to the message-queue, waiting for room at most until the given deadline.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+            * \return channel_status success, not_ready if the (bounded) storage was still full at the deadline, or closed.
+            *
+            * \note Only waiting for room is limited by the deadline, not acquiring the lock. Unlike operator<<, a closed channel
+            *       is reported by the result instead of an exception.
+            */
+            template<typename Clock, typename Duration>
+            channel_status push_until(const MsgType& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                channel_status status = this->__wait_not_full_until(lock, deadline);
+                if (status == channel_status::success)
+                {
+                    this->__msgQueue.push(msg);
+                    this->__notify_pushed(1);
+                }
+                return status;
+            }
+
+            /** \brief Function that adds a message to the message-queue, waiting for room at most until the given deadline.
+            *         Message is taken as r-value; it is left untouched if it could not be added.
+            *
+            * \see push_until(const MsgType&, const std::chrono::time_point<Clock, Duration>&)
+            */
+            template<typename Clock, typename Duration>
+            channel_status push_until(MsgType&& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                channel_status status = this->__wait_not_full_until(lock, deadline);
+                if (status == channel_status::success)
+                {
+                    this->__msgQueue.push(std::move(msg));
+                    this->__notify_pushed(1);
+                }
+                return status;
+            }
+
+            /** \brief Function that adds a message to the message-queue, waiting for room at most for the given duration.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \param timeout const std::chrono::duration<Rep, Period>& Maximum time to wait.
+            * \return channel_status success, not_ready on timeout, or closed.
+            */
+            template<typename Rep, typename Period>
+            channel_status push_for(const MsgType& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->push_until(msg, std::chrono::steady_clock::now() + timeout);
+            }
+
+            template<typename Rep, typename Period>
+            channel_status push_for(MsgType&& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->push_until(std::move(msg), std::chrono::steady_clock::now() + timeout);
+            }
+
+            /** \brief Function that adds a sequence of messages to the message-queue, acquiring the lock only once and waking up
+            *         waiting receivers only once for the whole batch.
+            *
+            * \param first InputIt Begin of the sequence. Use std::make_move_iterator to move the messages into the channel.
+            * \param last InputIt End of the sequence.
+            * \return void
+            *
+            * \note Function blocks until thread-safe access to the queue is possible. In case of bounded storage, it waits for room
+            *       whenever the storage gets full in between; the part of the batch that was already added is handed over to the
+            *       receivers before.
+            * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
+            */
+            template<typename InputIt>
+            void push_bulk(InputIt first, InputIt last)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (this->__closed)
+                {
+                    throw closed_channel_error();
+                }
+                std::size_t pushed = 0;
+                for (; first != last; ++first)
+                {
+                    if (is_bounded && this->__full())
+                    {
+                        this->__notify_pushed(pushed);
+                        pushed = 0;
+                        this->__wait_not_full(lock);
+                    }
+                    this->__msgQueue.push(*first);
+                    ++pushed;
+                }
+                this->__notify_pushed(pushed);
+            }
+
+            /** \brief Function that adds all messages of a range (anything that supports std::begin/std::end) to the message-queue.
+            *
+            * \param range const Range& Messages to add.
+            * \return void
+            * \see push_bulk(InputIt, InputIt)
+            */
+            template<typename Range>
+            void push_bulk(const Range& range)
+            {
+                this->push_bulk(std::begin(range), std::end(range));
+            }
+
             /**
             Block 2: Fetching messages from the queue.
             */
@@ -118,20 +333,15 @@ namespace concurrent
             /** \brief Stream-like function that takes the next available message from the internal message queue.
             *
             * \param destination MsgType& Variable to write the message to.
-            * \return void
+            * \return bool "true" if a message was taken, "false" if the channel was closed and all remaining messages have been taken (end of stream).
             *
-            * \note Function blocks until thread-safe access to the queue is possible and at least one message arrived.
+            * \note Function blocks until thread-safe access to the queue is possible and at least one message arrived or the channel got closed.
             */
-            void operator>>(MsgType& destination)
+            bool operator>>(MsgType& destination)
             {
                 std::unique_lock<std::mutex> lock(this->__accessMutex); // Since std::queue is not thread-safe, we need the lock here.
-                this->__waitCondition.wait(lock, [this]()->bool             // We have to wait for the given condition after getting the lock granted.
-                {
-                    return !this->__msgQueue.empty();
-                }
-                );
-                destination = this->__msgQueue.front();
-                this->__msgQueue.pop();
+                this->__wait_not_empty(lock);
+                return this->__take(&destination, 1) == 1;
             }
 
             /** \brief Stream-look-alike function that takes the next available message from the internal message queue,
@@ -146,13 +356,7 @@ namespace concurrent
             {
                 if (this->__accessMutex.try_lock())
                 {
-                    bool couldTakeMessage = false;
-                    if (!this->__msgQueue.empty())
-                    {
-                        destination = this->__msgQueue.front();
-                        this->__msgQueue.pop();
-                        couldTakeMessage = true;
-                    }
+                    bool couldTakeMessage = this->__take(&destination, 1) == 1;
                     this->__accessMutex.unlock();
                     return couldTakeMessage;
                 }
@@ -162,15 +366,314 @@ namespace concurrent
                 }
             }
 
+            /** \brief Function that takes the next message if that is possible without waiting for one.
+            *         In contrast to operator>, it waits for the lock, so it never fails due to contention.
+            *
+            * \param destination MsgType& Variable to write the message to.
+            * \return channel_status success, not_ready if there is no message, or closed if the channel was closed and all remaining messages have been taken.
+            */
+            channel_status try_receive(MsgType& destination)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (this->__take(&destination, 1) == 1)
+                {
+                    return channel_status::success;
+                }
+                return this->__closed ? channel_status::closed : channel_status::not_ready;
+            }
+
+            /** \brief Function that takes the next available message, waiting for one at most until the given deadline.
+            *         Unlike operator>, it never fails just because another thread holds the lock.
+            *
+            * \param destination MsgType& Variable to write the message to.
+            * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+            * \return channel_status success, not_ready if there was still no message at the deadline, or closed if the channel
+            *         was closed and all remaining messages have been taken.
+            *
+            * \note Only waiting for a message is limited by the deadline, not acquiring the lock.
+            */
+            template<typename Clock, typename Duration>
+            channel_status pop_until(MsgType& destination, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__waitCondition.wait_until(lock, deadline, [this]()->bool
+                {
+                    return !this->__msgQueue.empty() || this->__closed;
+                });
+                if (this->__take(&destination, 1) == 1)
+                {
+                    return channel_status::success;
+                }
+                return this->__closed ? channel_status::closed : channel_status::not_ready;
+            }
+
+            /** \brief Function that takes the next available message, waiting for one at most for the given duration.
+            *
+            * \param destination MsgType& Variable to write the message to.
+            * \param timeout const std::chrono::duration<Rep, Period>& Maximum time to wait.
+            * \return channel_status success, not_ready on timeout, or closed.
+            */
+            template<typename Rep, typename Period>
+            channel_status pop_for(MsgType& destination, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->pop_until(destination, std::chrono::steady_clock::now() + timeout);
+            }
+
+            /** \brief Function that takes up to max messages from the message-queue in one go.
+            *
+            * \param destination OutputIt Iterator to write (move) the messages to, e.g. a std::back_inserter.
+            * \param max std::size_t Maximum number of messages to take.
+            * \return std::size_t Number of messages taken; at least one unless max is zero or the channel was closed and all remaining messages have been taken.
+            *
+            * \note Function blocks until thread-safe access to the queue is possible and at least one message arrived or the channel got closed.
+            */
+            template<typename OutputIt>
+            std::size_t pop_bulk(OutputIt destination, std::size_t max)
+            {
+                if (max == 0)
+                {
+                    return 0;
+                }
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__wait_not_empty(lock);
+                return this->__take(destination, max);
+            }
+
+            /** \brief Function that moves all messages that are currently available to the end of the given container.
+            *
+            * \param container Container& Container offering push_back(), e.g. std::vector or std::deque.
+            * \return std::size_t Number of messages taken, possibly zero.
+            *
+            * \note Function blocks until thread-safe access to the queue is possible, but does not wait for messages.
+            */
+            template<typename Container>
+            std::size_t drain_into(Container& container)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                return this->__take(std::back_inserter(container), static_cast<std::size_t>(-1));
+            }
+
+            /**
+            Block 3: Closing the channel.
+            */
+
+
+            /** \brief Closes the channel. No further messages can be added, but the ones that are already queued can still be taken.
+            *         Receivers that are blocked on an empty channel wake up and get the end-of-stream result, blocked senders get
+            *         a closed_channel_error. Closing an already closed channel has no effect.
+            */
+            void close()
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (!this->__closed)
+                {
+                    this->__closed = true;
+                    this->__waitCondition.notify_all();
+                    this->__notFullCondition.notify_all();
+                    this->__selectors.notify_all();
+                }
+            }
+
+            bool closed() const
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                return this->__closed;
+            }
+
+            /** \brief Registers a waiter that gets signaled on any change of the channel's state. Used by concurrent::select.
+            */
+            void attach_waiter(internal::select_waiter* waiter)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__selectors.attach(waiter);
+            }
+
+            void detach_waiter(internal::select_waiter* waiter)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__selectors.detach(waiter);
+            }
+
+            /** \brief Sets how receivers (and senders, in case of bounded storage) wait before they get parked.
+            *
+            * \param strategy const wait_strategy& E.g. wait_strategy::latency_optimized() or wait_strategy::cpu_friendly().
+            */
+            void set_wait_strategy(const wait_strategy& strategy)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__waitCondition.set_strategy(strategy);
+                this->__notFullCondition.set_strategy(strategy);
+            }
+
+            wait_strategy get_wait_strategy() const
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                return this->__waitCondition.strategy();
+            }
+
         private:
             // Prohibitions
             channel(const channel& rhs);                /**< Channels must not be copied */
             channel& operator=(const channel& rhs);     /**< Channels must not be assigned to other channels */
             // Parameters
-            std::mutex __accessMutex;
-            std::condition_variable __waitCondition;
+            mutable std::mutex __accessMutex;
+            internal::parking_condition __waitCondition;
+            internal::parking_condition __notFullCondition; /**< Only used in case of bounded storage */
+            bool __closed;
+            internal::select_waiter_list __selectors;       /**< Waiters of selects that are currently blocked on this channel */
+
+            storage_type __msgQueue;
+
+            bool __full() const
+            {
+                return if_member_full<is_bounded, storage_type>::exec(this->__msgQueue);
+            }
+
+            channel_status __send_status() const
+            {
+                if (this->__closed)
+                {
+                    return channel_status::closed;
+                }
+                return this->__full() ? channel_status::not_ready : channel_status::success;
+            }
+
+            /** \brief Waits until there is room for a message. Lock has to be held by the caller.
+            *
+            * \throw closed_channel_error if the channel is or gets closed.
+            */
+            void __wait_not_full(std::unique_lock<std::mutex>& lock)
+            {
+                if (is_bounded)
+                {
+                    this->__notFullCondition.wait(lock, [this]()->bool
+                    {
+                        return this->__closed || !this->__full();
+                    });
+                }
+                if (this->__closed)
+                {
+                    throw closed_channel_error();
+                }
+            }
+
+            /** \brief Waits until there is room for a message, the channel got closed or the deadline passed. Lock has to be held by the caller.
+            *
+            * \return channel_status success if there is room, not_ready on timeout, or closed.
+            */
+            template<typename Clock, typename Duration>
+            channel_status __wait_not_full_until(std::unique_lock<std::mutex>& lock, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                if (is_bounded)
+                {
+                    this->__notFullCondition.wait_until(lock, deadline, [this]()->bool
+                    {
+                        return this->__closed || !this->__full();
+                    });
+                }
+                return this->__send_status();
+            }
+
+            /** \brief Waits until there is a message or the channel got closed. Lock has to be held by the caller.
+            */
+            void __wait_not_empty(std::unique_lock<std::mutex>& lock)
+            {
+                this->__waitCondition.wait(lock, [this]()->bool             // We have to wait for the given condition after getting the lock granted.
+                {
+                    return !this->__msgQueue.empty() || this->__closed;
+                }
+                );
+            }
+
+            /** \brief Wakes up as many receivers as there are new messages, using a single notification.
+            */
+            void __notify_pushed(std::size_t pushed)
+            {
+                if (pushed == 1)
+                {
+                    this->__waitCondition.notify_one();
+                }
+                else if (pushed > 1)
+                {
+                    this->__waitCondition.notify_all();
+                }
+                if (pushed > 0 && !this->__selectors.empty())
+                {
+                    this->__selectors.notify_all();
+                }
+            }
+
+            /** \brief Moves up to max messages to destination. Lock has to be held by the caller.
+            */
+            template<typename OutputIt>
+            std::size_t __take(OutputIt destination, std::size_t max)
+            {
+                std::size_t taken = 0;
+                while (taken < max && !this->__msgQueue.empty())
+                {
+                    *destination++ = std::move(this->__msgQueue.front());
+                    this->__msgQueue.pop();
+                    ++taken;
+                }
+                if (is_bounded && taken > 0)
+                {
+                    if (taken == 1)
+                    {
+                        this->__notFullCondition.notify_one();
+                    }
+                    else
+                    {
+                        this->__notFullCondition.notify_all();
+                    }
+                    if (!this->__selectors.empty())
+                    {
+                        this->__selectors.notify_all(); // Selects might wait to send.
+                    }
+                }
+                return taken;
+            }
+    };
+
+    template<typename MsgType, template<typename, typename...> class Storage, typename... OptArgs>
+    const bool channel<MsgType, Storage, OptArgs...>::is_bounded;
+
+    /** \brief Lock-free version of the channel class, selected by using concurrent::mpmc_ring as storage.
+    *         Any number of threads may send and receive concurrently.
+    *  \param MsgType Type of the messages that are exchanged between the communications partners.
+    *  \param OptArgs Optional arguments that are handled over to the ring, e.g. a custom allocator.
+    *  \see internal::ring_channel<> for details.
+    */
+    template<typename MsgType, typename... OptArgs>
+    class channel<MsgType, mpmc_ring, OptArgs...> : public internal::ring_channel<MsgType, mpmc_ring<MsgType, OptArgs...>>
+    {
+        typedef internal::ring_channel<MsgType, mpmc_ring<MsgType, OptArgs...>> base_type;
+
+        public:
+            channel(void) {}
+            explicit channel(std::size_t capacity) : base_type(capacity) {}
+            template<typename Alloc>
+            channel(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity = base_type::storage_type::default_capacity)
+                : base_type(std::allocator_arg, alloc, capacity) {}
+    };
+
+    /** \brief Wait-free single-producer/single-consumer version of the channel class, selected by using concurrent::spsc_ring as storage.
+    *         Sending and receiving never wait for each other as long as the channel is neither full nor empty.
+    *  \param MsgType Type of the messages that are exchanged between the communications partners.
+    *  \param OptArgs Optional arguments that are handled over to the ring, e.g. a custom allocator.
+    *  \note At any time, only one thread may send and only one thread may receive.
+    *  \see internal::ring_channel<> for details.
+    */
+    template<typename MsgType, typename... OptArgs>
+    class channel<MsgType, spsc_ring, OptArgs...> : public internal::ring_channel<MsgType, spsc_ring<MsgType, OptArgs...>>
+    {
+        typedef internal::ring_channel<MsgType, spsc_ring<MsgType, OptArgs...>> base_type;
 
-            Storage<MsgType, OptArgs...> __msgQueue;
+        public:
+            channel(void) {}
+            explicit channel(std::size_t capacity) : base_type(capacity) {}
+            template<typename Alloc>
+            channel(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity = base_type::storage_type::default_capacity)
+                : base_type(std::allocator_arg, alloc, capacity) {}
     };
 
     /** \brief This is the channel helper class. Since a channel is regularly used in different threads,
@@ -187,7 +690,14 @@ namespace concurrent
     template<typename MsgType, template<typename, typename...> class Storage = std::queue, typename... OptArgs>
     struct chan
     {
+            typedef MsgType value_type;
+
             chan(): __me(std::make_shared<channel<MsgType, Storage, OptArgs...>>())  {}
+            explicit chan(std::size_t capacity): __me(std::make_shared<channel<MsgType, Storage, OptArgs...>>(capacity))  {}
+            template<typename Alloc>
+            chan(std::allocator_arg_t, const Alloc& alloc): __me(std::make_shared<channel<MsgType, Storage, OptArgs...>>(std::allocator_arg, alloc))  {}
+            template<typename Alloc>
+            chan(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity): __me(std::make_shared<channel<MsgType, Storage, OptArgs...>>(std::allocator_arg, alloc, capacity))  {}
             void operator<<(const MsgType& msg)
             {
                 *__me << msg;
@@ -204,14 +714,105 @@ namespace concurrent
             {
                 return (*__me < std::forward<MsgType>(msg));
             }
-            void operator>>(MsgType& destination)
+            bool operator>>(MsgType& destination)
             {
-                *__me > destination;
+                return *__me >> destination;
             }
             bool operator>(MsgType& destination)
             {
                 return *__me > destination;
             }
+            template<typename InputIt>
+            void push_bulk(InputIt first, InputIt last)
+            {
+                __me->push_bulk(first, last);
+            }
+            template<typename Range>
+            void push_bulk(const Range& range)
+            {
+                __me->push_bulk(range);
+            }
+            template<typename OutputIt>
+            std::size_t pop_bulk(OutputIt destination, std::size_t max)
+            {
+                return __me->pop_bulk(destination, max);
+            }
+            template<typename Container>
+            std::size_t drain_into(Container& container)
+            {
+                return __me->drain_into(container);
+            }
+            channel_status try_send(const MsgType& msg)
+            {
+                return __me->try_send(msg);
+            }
+            channel_status try_send(MsgType&& msg)
+            {
+                return __me->try_send(std::forward<MsgType>(msg));
+            }
+            template<typename... Args>
+            void emplace(Args&&... args)
+            {
+                __me->emplace(std::forward<Args>(args)...);
+            }
+            channel_status try_receive(MsgType& destination)
+            {
+                return __me->try_receive(destination);
+            }
+            template<typename Clock, typename Duration>
+            channel_status push_until(const MsgType& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                return __me->push_until(msg, deadline);
+            }
+            template<typename Clock, typename Duration>
+            channel_status push_until(MsgType&& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                return __me->push_until(std::forward<MsgType>(msg), deadline);
+            }
+            template<typename Rep, typename Period>
+            channel_status push_for(const MsgType& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return __me->push_for(msg, timeout);
+            }
+            template<typename Rep, typename Period>
+            channel_status push_for(MsgType&& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return __me->push_for(std::forward<MsgType>(msg), timeout);
+            }
+            template<typename Clock, typename Duration>
+            channel_status pop_until(MsgType& destination, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                return __me->pop_until(destination, deadline);
+            }
+            template<typename Rep, typename Period>
+            channel_status pop_for(MsgType& destination, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return __me->pop_for(destination, timeout);
+            }
+            void close()
+            {
+                __me->close();
+            }
+            bool closed() const
+            {
+                return __me->closed();
+            }
+            void attach_waiter(internal::select_waiter* waiter)
+            {
+                __me->attach_waiter(waiter);
+            }
+            void detach_waiter(internal::select_waiter* waiter)
+            {
+                __me->detach_waiter(waiter);
+            }
+            void set_wait_strategy(const wait_strategy& strategy)
+            {
+                __me->set_wait_strategy(strategy);
+            }
+            wait_strategy get_wait_strategy() const
+            {
+                return __me->get_wait_strategy();
+            }
         private:
             std::shared_ptr< channel<MsgType, Storage, OptArgs...> > __me;
     };
@@ -227,6 +828,18 @@ namespace concurrent
     {
         return chan<MsgType, Storage, OptArgs...>();
     }
+
+    /** \brief Helper function to automatically create bounded channel-objects that are managed by shared_ptr objects.
+    *
+    * \param capacity std::size_t Maximum number of messages that may be queued at the same time.
+    * \return Chan<MsgType,Storage> Channel using type MsgType and Storage, managed by the wrapper struct Chan<>.
+    *
+    */
+    template<typename MsgType, template<typename, typename...> class Storage, typename... OptArgs>
+    inline chan<MsgType, Storage, OptArgs...> make_chan(std::size_t capacity)
+    {
+        return chan<MsgType, Storage, OptArgs...>(capacity);
+    }
 }
 
 
@@ -0,0 +1,26 @@
+#ifndef __CONCURRENT_CHANNEL_STATUS_HPP__
+#define __CONCURRENT_CHANNEL_STATUS_HPP__
+
+#include <stdexcept>
+
+namespace concurrent
+{
+    /** \brief Result of a non-blocking channel operation (try_send, try_receive).
+     */
+    enum class channel_status
+    {
+        success,        /**< The message was sent or received */
+        not_ready,      /**< The channel is full (send) or empty (receive) at the moment */
+        closed          /**< The channel was closed (and, in case of receiving, all remaining messages have been taken) */
+    };
+
+    /** \brief Exception thrown by blocking send operations on a closed channel.
+     */
+    class closed_channel_error : public std::logic_error
+    {
+        public:
+            closed_channel_error() : std::logic_error("send on closed channel") {}
+    };
+}
+
+#endif // !__CONCURRENT_CHANNEL_STATUS_HPP__
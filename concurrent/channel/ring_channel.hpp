@@ -0,0 +1,547 @@
+#ifndef __CONCURRENT_CHANNEL_RING_CHANNEL_HPP__
+#define __CONCURRENT_CHANNEL_RING_CHANNEL_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent/channel/channel_status.hpp"
+#include "concurrent/internal/select_waiter.hpp"
+#include "concurrent/internal/waiter.hpp"
+#include "concurrent/wait_strategy.hpp"
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Common implementation of the lock-free channels, i.e. channels on top of concurrent::mpmc_ring or concurrent::spsc_ring.
+        *         It offers the same operators as the locking channel, but none of them acquires a lock as long as it does not have to wait.
+        *         Threads only get parked (see concurrent::internal::waiter) if the channel is empty (>>) or full (<<).
+        *  \param MsgType Type of the messages that are exchanged between the communications partners.
+        *  \param Ring Ring type offering non-blocking try_push(U&&), try_emplace(Args&&...) and try_pop(MsgType&).
+        *  \note Receiving requires MsgType to be default-constructible, since messages are moved out of the ring into an existing object.
+        *  \note In contrast to the locking version, the non-blocking operators < and > only fail if the channel is full or empty,
+        *        never due to contention.
+        *  \note Every push attempt registers as in flight before it checks whether the channel is closed. close() waits for the
+        *        attempts in flight to finish before receivers get to see the channel closed, so a message whose sender was told
+        *        success is always delivered - as with the locking version, where both happen under the channel's mutex.
+        */
+        template<typename MsgType, typename Ring>
+        class ring_channel
+        {
+            static_assert( std::is_move_constructible<MsgType>::value, "The message type requires to be move-constructible!" );
+
+            public:
+                typedef Ring storage_type;
+                typedef MsgType value_type;
+
+                ring_channel(void) : __closing(false), __closed(false), __sending(0), __selectorCount(0) {}
+
+                /** \brief C'tor.
+                *
+                * \param capacity std::size_t Maximum number of messages that may be queued at the same time (rounded up to a power of two).
+                */
+                explicit ring_channel(std::size_t capacity) : __msgQueue(capacity), __closing(false), __closed(false), __sending(0), __selectorCount(0) {}
+
+                /** \brief C'tor that hands an allocator over to the ring, which uses it for its slot buffer.
+                *
+                * \param alloc const Alloc& Allocator (or anything the ring's allocator can be constructed from).
+                * \param capacity std::size_t Maximum number of messages that may be queued at the same time (rounded up to a power of two).
+                */
+                template<typename Alloc>
+                ring_channel(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity)
+                    : __msgQueue(capacity, alloc), __closing(false), __closed(false), __sending(0), __selectorCount(0) {}
+                ~ring_channel() {}
+
+                /**
+                Block 1: Adding messages to the queue.
+                */
+
+                /** \brief Stream-style function that adds a message to the channel. Blocks while the channel is full.
+                *
+                * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
+                */
+                void operator<<(const MsgType& msg)
+                {
+                    this->__send([&]()->bool { return this->__msgQueue.try_push(msg); });
+                }
+
+                /** \brief Stream-style function that adds a message to the channel, taken as r-value. Blocks while the channel is full.
+                *
+                * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
+                */
+                void operator<<(MsgType&& msg)
+                {
+                    this->__send([&]()->bool { return this->__msgQueue.try_push(std::move(msg)); });
+                }
+
+                /** \brief Stream-look-alike function that adds a message to the channel if it is not full.
+                *
+                * \return bool "true" if the message could be added to the channel, "false" otherwise (also if the channel is closed).
+                */
+                bool operator<(const MsgType& msg)
+                {
+                    return this->try_send(msg) == channel_status::success;
+                }
+
+                /** \brief Stream-look-alike function that adds a message to the channel if it is not full. Message is taken as r-value.
+                *
+                * \return bool "true" if the message could be added to the channel, "false" otherwise. In the latter case, msg is left untouched.
+                */
+                bool operator<(MsgType&& msg)
+                {
+                    return this->try_send(std::move(msg)) == channel_status::success;
+                }
+
+                /** \brief Function that adds a message to the channel if it is not full.
+                *
+                * \return channel_status success, not_ready if the channel is full, or closed.
+                */
+                channel_status try_send(const MsgType& msg)
+                {
+                    channel_status status = this->__try_send([&]()->bool { return this->__msgQueue.try_push(msg); });
+                    if (status == channel_status::success)
+                    {
+                        this->__notify_pushed(1);
+                    }
+                    return status;
+                }
+
+                /** \brief Function that adds a message to the channel if it is not full. Message is taken as r-value; it is left
+                *         untouched if it could not be added.
+                */
+                channel_status try_send(MsgType&& msg)
+                {
+                    channel_status status = this->__try_send([&]()->bool { return this->__msgQueue.try_push(std::move(msg)); });
+                    if (status == channel_status::success)
+                    {
+                        this->__notify_pushed(1);
+                    }
+                    return status;
+                }
+
+                /** \brief Function that constructs a message in place at the end of the channel. Blocks while the channel is full;
+                *         the message is only constructed once there is room.
+                *
+                * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
+                */
+                template<typename... Args>
+                void emplace(Args&&... args)
+                {
+                    this->__send([&]()->bool { return this->__msgQueue.try_emplace(std::forward<Args>(args)...); });
+                }
+
+                /** \brief Function that adds a message to the channel, waiting for room at most until the given deadline.
+                *
+                * \return channel_status success, not_ready if the channel was still full at the deadline, or closed.
+                */
+                template<typename Clock, typename Duration>
+                channel_status push_until(const MsgType& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+                {
+                    return this->__send_until([&]()->bool { return this->__msgQueue.try_push(msg); }, deadline);
+                }
+
+                /** \brief Function that adds a message to the channel, waiting for room at most until the given deadline.
+                *         Message is taken as r-value; it is left untouched if it could not be added.
+                */
+                template<typename Clock, typename Duration>
+                channel_status push_until(MsgType&& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+                {
+                    return this->__send_until([&]()->bool { return this->__msgQueue.try_push(std::move(msg)); }, deadline);
+                }
+
+                template<typename Rep, typename Period>
+                channel_status push_for(const MsgType& msg, const std::chrono::duration<Rep, Period>& timeout)
+                {
+                    return this->push_until(msg, std::chrono::steady_clock::now() + timeout);
+                }
+
+                template<typename Rep, typename Period>
+                channel_status push_for(MsgType&& msg, const std::chrono::duration<Rep, Period>& timeout)
+                {
+                    return this->push_until(std::move(msg), std::chrono::steady_clock::now() + timeout);
+                }
+
+                /** \brief Function that adds a sequence of messages to the channel, waking up waiting receivers only once for the whole batch.
+                *
+                * \param first InputIt Begin of the sequence. Use std::make_move_iterator to move the messages into the channel.
+                * \param last InputIt End of the sequence.
+                *
+                * \note Function blocks whenever the channel gets full in between; the part of the batch that was already added is
+                *       handed over to the receivers before.
+                * \throw closed_channel_error if the channel is (or gets, while waiting for room) closed.
+                */
+                template<typename InputIt>
+                void push_bulk(InputIt first, InputIt last)
+                {
+                    std::size_t pushed = 0;
+                    for (; first != last; ++first)
+                    {
+                        channel_status status = this->__try_send([&]()->bool { return this->__msgQueue.try_push(*first); });
+                        if (status == channel_status::success)
+                        {
+                            ++pushed;
+                            continue;
+                        }
+                        this->__notify_pushed(pushed);
+                        pushed = 0;
+                        if (status == channel_status::closed)
+                        {
+                            throw closed_channel_error();
+                        }
+                        this->__send([&]()->bool { return this->__msgQueue.try_push(*first); });
+                    }
+                    this->__notify_pushed(pushed);
+                }
+
+                /** \brief Function that adds all messages of a range (anything that supports std::begin/std::end) to the channel.
+                *
+                * \see push_bulk(InputIt, InputIt)
+                */
+                template<typename Range>
+                void push_bulk(const Range& range)
+                {
+                    this->push_bulk(std::begin(range), std::end(range));
+                }
+
+                /**
+                Block 2: Fetching messages from the queue.
+                */
+
+                /** \brief Stream-like function that takes the next available message. Blocks while the channel is empty.
+                *
+                * \return bool "true" if a message was taken, "false" if the channel was closed and all remaining messages have been taken (end of stream).
+                */
+                bool operator>>(MsgType& destination)
+                {
+                    bool received = false;
+                    this->__notEmpty.wait([&]()->bool
+                    {
+                        received = this->__msgQueue.try_pop(destination);
+                        return received || this->__closed.load(std::memory_order_acquire);
+                    });
+                    if (!received)
+                    {
+                        received = this->__msgQueue.try_pop(destination); // Messages might have been added right before closing.
+                    }
+                    if (received)
+                    {
+                        this->__notify_taken(1);
+                    }
+                    return received;
+                }
+
+                /** \brief Stream-look-alike function that takes the next available message, if there is one.
+                *
+                * \return bool "true" if a message could be fetched from the channel, "false" otherwise.
+                */
+                bool operator>(MsgType& destination)
+                {
+                    return this->try_receive(destination) == channel_status::success;
+                }
+
+                /** \brief Function that takes the next available message, if there is one.
+                *
+                * \return channel_status success, not_ready if there is no message, or closed if the channel was closed and all remaining messages have been taken.
+                */
+                channel_status try_receive(MsgType& destination)
+                {
+                    if (this->__msgQueue.try_pop(destination))
+                    {
+                        this->__notify_taken(1);
+                        return channel_status::success;
+                    }
+                    return this->__closed.load(std::memory_order_acquire) ? channel_status::closed : channel_status::not_ready;
+                }
+
+                /** \brief Function that takes the next available message, waiting for one at most until the given deadline.
+                *
+                * \return channel_status success, not_ready if there was still no message at the deadline, or closed if the channel
+                *         was closed and all remaining messages have been taken.
+                */
+                template<typename Clock, typename Duration>
+                channel_status pop_until(MsgType& destination, const std::chrono::time_point<Clock, Duration>& deadline)
+                {
+                    bool received = false;
+                    this->__notEmpty.wait_until([&]()->bool
+                    {
+                        received = this->__msgQueue.try_pop(destination);
+                        return received || this->__closed.load(std::memory_order_acquire);
+                    }, deadline);
+                    if (!received)
+                    {
+                        received = this->__msgQueue.try_pop(destination);
+                    }
+                    if (received)
+                    {
+                        this->__notify_taken(1);
+                        return channel_status::success;
+                    }
+                    return this->__closed.load(std::memory_order_acquire) ? channel_status::closed : channel_status::not_ready;
+                }
+
+                template<typename Rep, typename Period>
+                channel_status pop_for(MsgType& destination, const std::chrono::duration<Rep, Period>& timeout)
+                {
+                    return this->pop_until(destination, std::chrono::steady_clock::now() + timeout);
+                }
+
+                /** \brief Function that takes up to max messages from the channel in one go.
+                *
+                * \param destination OutputIt Iterator to write (move) the messages to, e.g. a std::back_inserter.
+                * \param max std::size_t Maximum number of messages to take.
+                * \return std::size_t Number of messages taken; at least one unless max is zero or the channel was closed and all remaining messages have been taken.
+                *
+                * \note Function blocks until at least one message arrived or the channel got closed.
+                */
+                template<typename OutputIt>
+                std::size_t pop_bulk(OutputIt destination, std::size_t max)
+                {
+                    if (max == 0)
+                    {
+                        return 0;
+                    }
+                    MsgType msg;
+                    if (!(*this >> msg))
+                    {
+                        return 0;
+                    }
+                    *destination++ = std::move(msg);
+                    return 1 + this->__take(destination, max - 1);
+                }
+
+                /** \brief Function that moves all messages that are currently available to the end of the given container.
+                *
+                * \param container Container& Container offering push_back(), e.g. std::vector or std::deque.
+                * \return std::size_t Number of messages taken, possibly zero.
+                */
+                template<typename Container>
+                std::size_t drain_into(Container& container)
+                {
+                    return this->__take(std::back_inserter(container), static_cast<std::size_t>(-1));
+                }
+
+                /**
+                Block 3: Closing the channel.
+                */
+
+                /** \brief Closes the channel. No further messages can be added, but the ones that are already queued can still be taken.
+                *         Receivers that are blocked on an empty channel wake up and get the end-of-stream result, blocked senders get
+                *         a closed_channel_error.
+                *
+                * \note Waits for push attempts that are in flight, i.e. that passed the check for a closed channel already; their
+                *       messages are delivered before the end of the stream.
+                */
+                void close()
+                {
+                    this->__closing.store(true, std::memory_order_seq_cst);
+                    this->__notFull.notify_all(); // Blocked senders give up.
+                    this->__drained.wait([this]()->bool { return this->__sending.load(std::memory_order_seq_cst) == 0; });
+                    this->__closed.store(true, std::memory_order_release);
+                    this->__notEmpty.notify_all();
+                    this->__notify_selectors();
+                }
+
+                bool closed() const
+                {
+                    return this->__closing.load(std::memory_order_acquire);
+                }
+
+                /** \brief Registers a waiter that gets signaled on any change of the channel's state. Used by concurrent::select.
+                */
+                void attach_waiter(select_waiter* waiter)
+                {
+                    std::lock_guard<std::mutex> lock(this->__selectorMutex);
+                    this->__selectors.attach(waiter);
+                    this->__selectorCount.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst); // The select re-checks the ring afterwards, see waiter::wait().
+                }
+
+                void detach_waiter(select_waiter* waiter)
+                {
+                    std::lock_guard<std::mutex> lock(this->__selectorMutex);
+                    this->__selectors.detach(waiter);
+                    this->__selectorCount.fetch_sub(1);
+                }
+
+                /** \brief Sets how receivers and senders wait before they get parked.
+                *
+                * \note Has to be called before the channel is shared between threads.
+                */
+                void set_wait_strategy(const wait_strategy& strategy)
+                {
+                    this->__notEmpty.set_strategy(strategy);
+                    this->__notFull.set_strategy(strategy);
+                }
+
+                wait_strategy get_wait_strategy() const
+                {
+                    return this->__notEmpty.strategy();
+                }
+
+            private:
+                // Prohibitions
+                ring_channel(const ring_channel& rhs);                /**< Channels must not be copied */
+                ring_channel& operator=(const ring_channel& rhs);     /**< Channels must not be assigned to other channels */
+                // Parameters
+                storage_type __msgQueue;
+                waiter __notEmpty;                                    /**< Consumers waiting for messages */
+                waiter __notFull;                                     /**< Producers waiting for room */
+                waiter __drained;                                     /**< close() waiting for the push attempts in flight */
+                std::atomic<bool> __closing;                          /**< Set first by close(); senders check it */
+                std::atomic<bool> __closed;                           /**< Set by close() once no push attempt is in flight; receivers check it */
+                std::atomic<std::size_t> __sending;                   /**< Push attempts in flight */
+                std::mutex __selectorMutex;                           /**< Only taken if selects are registered */
+                select_waiter_list __selectors;
+                std::atomic<unsigned> __selectorCount;
+
+                /** \brief Blocks until tryPush() succeeds.
+                *
+                * \throw closed_channel_error if the channel is or gets closed.
+                */
+                template<typename TryPush>
+                void __send(TryPush tryPush)
+                {
+                    channel_status status = channel_status::not_ready;
+                    this->__notFull.wait([&]()->bool
+                    {
+                        status = this->__try_send(tryPush);
+                        return status != channel_status::not_ready;
+                    });
+                    if (status == channel_status::closed)
+                    {
+                        throw closed_channel_error();
+                    }
+                    this->__notify_pushed(1);
+                }
+
+                /** \brief Runs a single push attempt, registered as in flight, unless the channel is closing.
+                *
+                * \return channel_status success, not_ready if the ring is full, or closed.
+                */
+                template<typename TryPush>
+                channel_status __try_send(TryPush&& tryPush)
+                {
+                    // Announce first, check afterwards; close() does it the other way round (both seq_cst).
+                    this->__sending.fetch_add(1, std::memory_order_seq_cst);
+                    if (this->__closing.load(std::memory_order_seq_cst))
+                    {
+                        this->__leave_send();
+                        return channel_status::closed;
+                    }
+                    bool pushed = false;
+                    try
+                    {
+                        pushed = tryPush();
+                    }
+                    catch (...)
+                    {
+                        this->__leave_send();
+                        throw;
+                    }
+                    this->__leave_send();
+                    return pushed ? channel_status::success : channel_status::not_ready;
+                }
+
+                void __leave_send()
+                {
+                    this->__sending.fetch_sub(1, std::memory_order_seq_cst);
+                    if (this->__closing.load(std::memory_order_seq_cst))
+                    {
+                        this->__drained.notify_all();
+                    }
+                }
+
+                /** \brief Waits until tryPush() succeeds, the channel gets closed or the deadline passed.
+                */
+                template<typename TryPush, typename Clock, typename Duration>
+                channel_status __send_until(TryPush tryPush, const std::chrono::time_point<Clock, Duration>& deadline)
+                {
+                    channel_status status = channel_status::not_ready;
+                    this->__notFull.wait_until([&]()->bool
+                    {
+                        status = this->__try_send(tryPush);
+                        return status != channel_status::not_ready;
+                    }, deadline);
+                    if (status == channel_status::success)
+                    {
+                        this->__notify_pushed(1);
+                    }
+                    return status;
+                }
+
+                void __notify_pushed(std::size_t pushed)
+                {
+                    if (pushed == 1)
+                    {
+                        this->__notEmpty.notify_one();
+                    }
+                    else if (pushed > 1)
+                    {
+                        this->__notEmpty.notify_all();
+                    }
+                    if (pushed > 0)
+                    {
+                        this->__notify_selectors_unfenced();
+                    }
+                }
+
+                void __notify_taken(std::size_t taken)
+                {
+                    if (taken == 1)
+                    {
+                        this->__notFull.notify_one();
+                    }
+                    else if (taken > 1)
+                    {
+                        this->__notFull.notify_all();
+                    }
+                    if (taken > 0)
+                    {
+                        this->__notify_selectors_unfenced();
+                    }
+                }
+
+                void __notify_selectors()
+                {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    this->__notify_selectors_unfenced();
+                }
+
+                /** \brief Signals all registered selects. Relies on the caller having issued a sequentially consistent fence after
+                *         changing the channel's state, which waiter::notify_one() / notify_all() already did.
+                */
+                void __notify_selectors_unfenced()
+                {
+                    if (this->__selectorCount.load(std::memory_order_relaxed) > 0)
+                    {
+                        std::lock_guard<std::mutex> lock(this->__selectorMutex);
+                        this->__selectors.notify_all();
+                    }
+                }
+
+                /** \brief Moves up to max messages that are available without waiting to destination.
+                */
+                template<typename OutputIt>
+                std::size_t __take(OutputIt destination, std::size_t max)
+                {
+                    std::size_t taken = 0;
+                    MsgType msg;
+                    while (taken < max && this->__msgQueue.try_pop(msg))
+                    {
+                        *destination++ = std::move(msg);
+                        ++taken;
+                    }
+                    this->__notify_taken(taken);
+                    return taken;
+                }
+        };
+    }
+}
+
+#endif // !__CONCURRENT_CHANNEL_RING_CHANNEL_HPP__
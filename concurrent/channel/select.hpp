@@ -0,0 +1,247 @@
+#ifndef __CONCURRENT_CHANNEL_SELECT_HPP__
+#define __CONCURRENT_CHANNEL_SELECT_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "concurrent/channel/channel_status.hpp"
+#include "concurrent/internal/select_waiter.hpp"
+#include "error_handling/scope_guard.hpp"
+
+namespace concurrent
+{
+    /** \brief Go-style select over several channels. Cases are registered with recv(), send() and otherwise(); wait() then
+     *         performs exactly one of them. If none is ready, the calling thread attaches a single internal::select_waiter to all
+     *         involved channels and sleeps until one of them signals a state change - there is no polling.
+     *         Works with any channel type (channel<>, chan<>, the lock-free channels) since it only relies on
+     *         try_send(), try_receive(), attach_waiter() and detach_waiter().
+     *
+     *         concurrent::select sel;
+     *         sel.recv(numbers, [](int n) { ... })
+     *            .recv(names, [](std::string s) { ... })
+     *            .send(results, 42, []() { ... });
+     *         while (sel.wait() != concurrent::select::npos) {}
+     *
+     *  \note Cases on a closed channel are disabled: a receive case only fires as long as there are messages left, a send case never.
+     *        If all cases are disabled and there is no default case, wait() returns select::npos.
+     *  \note Ready cases are tried round-robin, starting behind the one that fired last, so no case can starve the others.
+     *  \note The channels have to outlive the select object.
+     */
+    class select
+    {
+        public:
+            static const std::size_t npos = static_cast<std::size_t>(-1); /**< Returned by wait() if all channels have been closed */
+
+            select() : __hasDefault(false), __defaultIndex(npos), __next(0) {}
+
+            /** \brief Adds a receive case.
+             *
+             * \param ch Channel& Channel to receive from.
+             * \param f F Handler, called with the received message (as r-value) outside of any lock.
+             * \return *this
+             */
+            template<typename Channel, typename F>
+            select& recv(Channel& ch, F f)
+            {
+                this->__cases.emplace_back(new recv_case<Channel, F>(ch, std::move(f)));
+                return *this;
+            }
+
+            /** \brief Adds a send case. Every time it fires, a copy of msg is sent.
+             *
+             * \param ch Channel& Channel to send to.
+             * \param msg Msg Message to send.
+             * \param f F Handler, called without arguments after the message was sent.
+             * \return *this
+             */
+            template<typename Channel, typename Msg, typename F>
+            select& send(Channel& ch, Msg msg, F f)
+            {
+                this->__cases.emplace_back(new send_case<Channel, Msg, F>(ch, std::move(msg), std::move(f)));
+                return *this;
+            }
+
+            /** \brief Adds the default case, which fires if no other case is ready. Replaces a previously added default case.
+             *
+             * \param f F Handler, called without arguments.
+             * \return *this
+             */
+            template<typename F>
+            select& otherwise(F f)
+            {
+                if (!this->__hasDefault)
+                {
+                    this->__defaultIndex = this->__cases.size();
+                    this->__cases.emplace_back(nullptr); // Placeholder, keeps indices in the order of registration.
+                }
+                this->__hasDefault = true;
+                this->__default = std::move(f);
+                return *this;
+            }
+
+            /** \brief Performs one ready case and runs its handler. Blocks until a case is ready, unless there is a default case.
+             *
+             * \return std::size_t Index of the case that fired (in order of registration, counting the default case), or npos.
+             */
+            std::size_t wait()
+            {
+                std::size_t fired = npos;
+                bool allClosed = false;
+                if (!this->__try_all(fired, allClosed) && !this->__hasDefault && !allClosed)
+                {
+                    internal::select_waiter waiter;
+                    this->__attach(&waiter);
+                    auto detacher = scope_guard::make([&]() -> void { this->__detach(&waiter); });
+                    while (!this->__try_all(fired, allClosed) && !allClosed)
+                    {
+                        waiter.wait();
+                    }
+                }
+                if (fired != npos)
+                {
+                    this->__cases[fired]->run();
+                }
+                else if (this->__hasDefault && !allClosed)
+                {
+                    fired = this->__defaultIndex;
+                    this->__default();
+                }
+                return fired;
+            }
+
+        private:
+            // Prohibitions
+            select(const select& rhs);
+            select& operator=(const select& rhs);
+
+            struct case_base
+            {
+                virtual ~case_base() {}
+                virtual channel_status try_op() = 0;     /**< Performs the channel operation, if possible without waiting */
+                virtual void run() = 0;                  /**< Runs the handler of a case that succeeded in try_op() */
+                virtual void attach(internal::select_waiter* waiter) = 0;
+                virtual void detach(internal::select_waiter* waiter) = 0;
+            };
+
+            template<typename Channel, typename F>
+            struct recv_case : case_base
+            {
+                recv_case(Channel& ch, F f) : __ch(ch), __f(std::move(f)), __msg() {}
+
+                channel_status try_op()
+                {
+                    return this->__ch.try_receive(this->__msg);
+                }
+
+                void run()
+                {
+                    this->__f(std::move(this->__msg));
+                }
+
+                void attach(internal::select_waiter* waiter)
+                {
+                    this->__ch.attach_waiter(waiter);
+                }
+
+                void detach(internal::select_waiter* waiter)
+                {
+                    this->__ch.detach_waiter(waiter);
+                }
+
+                Channel& __ch;
+                F __f;
+                typename Channel::value_type __msg;      /**< Received message, kept until the handler runs */
+            };
+
+            template<typename Channel, typename Msg, typename F>
+            struct send_case : case_base
+            {
+                send_case(Channel& ch, Msg msg, F f) : __ch(ch), __msg(std::move(msg)), __f(std::move(f)) {}
+
+                channel_status try_op()
+                {
+                    return this->__ch.try_send(this->__msg);
+                }
+
+                void run()
+                {
+                    this->__f();
+                }
+
+                void attach(internal::select_waiter* waiter)
+                {
+                    this->__ch.attach_waiter(waiter);
+                }
+
+                void detach(internal::select_waiter* waiter)
+                {
+                    this->__ch.detach_waiter(waiter);
+                }
+
+                Channel& __ch;
+                Msg __msg;
+                F __f;
+            };
+
+            std::vector<std::unique_ptr<case_base>> __cases;
+            bool __hasDefault;
+            std::size_t __defaultIndex;
+            std::function<void()> __default;
+            std::size_t __next;                             /**< Case to try first on the next call, for fairness */
+
+            /** \brief Tries all cases once, starting at __next.
+             *
+             * \param fired std::size_t& Receives the index of the case whose operation succeeded.
+             * \param allClosed bool& Set to "true" if every case is disabled since its channel is closed (or there is no case at all).
+             * \return bool "true" if a case succeeded.
+             */
+            bool __try_all(std::size_t& fired, bool& allClosed)
+            {
+                std::size_t count = this->__cases.size();
+                std::size_t closedCount = 0;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    std::size_t index = (this->__next + i) % count;
+                    if (!this->__cases[index])
+                    {
+                        continue; // default case
+                    }
+                    channel_status status = this->__cases[index]->try_op();
+                    if (status == channel_status::success)
+                    {
+                        fired = index;
+                        this->__next = index + 1;
+                        return true;
+                    }
+                    if (status == channel_status::closed)
+                    {
+                        ++closedCount;
+                    }
+                }
+                std::size_t channelCases = count - (this->__hasDefault ? 1 : 0);
+                allClosed = closedCount == channelCases && (channelCases > 0 || !this->__hasDefault); // Nothing to wait for.
+                return false;
+            }
+
+            void __attach(internal::select_waiter* waiter)
+            {
+                for (auto& c : this->__cases)
+                {
+                    if (c) c->attach(waiter);
+                }
+            }
+
+            void __detach(internal::select_waiter* waiter)
+            {
+                for (auto& c : this->__cases)
+                {
+                    if (c) c->detach(waiter);
+                }
+            }
+    };
+}
+
+#endif // !__CONCURRENT_CHANNEL_SELECT_HPP__
@@ -0,0 +1,163 @@
+#ifndef __CONCURRENT_COROUTINE_HPP__
+#define __CONCURRENT_COROUTINE_HPP__
+
+// Everything in here requires compiler support for C++20 coroutines; without it, this header is empty.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define CONCURRENT_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef CONCURRENT_HAS_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "concurrent/executor.hpp"
+#include "concurrent/future.hpp"
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Continuation that resumes a suspended coroutine, on the executor it was suspended on if there was one, and
+         *         on the thread that provides the result otherwise.
+         */
+        struct coroutine_resumption
+        {
+            std::coroutine_handle<> handle;
+            executor* target;
+
+            void operator()()
+            {
+                if (this->target != nullptr)
+                {
+                    std::coroutine_handle<> handle = this->handle;
+                    this->target->submit([handle]() -> void { handle.resume(); });
+                }
+                else
+                {
+                    this->handle.resume();
+                }
+            }
+        };
+
+        /** \brief Promise type of coroutines returning a concurrent::future<R>. They start right away, and their result or
+         *         exception goes to the future.
+         */
+        template<typename R>
+        struct coroutine_promise_base
+        {
+            promise<R> result;
+
+            future<R> get_return_object()
+            {
+                return this->result.get_future();
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception()
+            {
+                this->result.set_exception(std::current_exception());
+            }
+        };
+
+        template<typename R>
+        struct coroutine_promise : coroutine_promise_base<R>
+        {
+            template<typename V>
+            void return_value(V&& value)
+            {
+                this->result.set_value(std::forward<V>(value));
+            }
+        };
+
+        template<>
+        struct coroutine_promise<void> : coroutine_promise_base<void>
+        {
+            void return_void()
+            {
+                this->result.set_value();
+            }
+        };
+    }
+
+    /** \brief Awaiter for a concurrent::future, e.g. the result of async_object::operator<=. A coroutine that awaits a result
+     *         which is not ready yet is suspended without blocking its thread; it is resumed once the functor has run:
+     *
+     *         concurrent::future<double> total(concurrent::async_object<account>& a, concurrent::async_object<account>& b)
+     *         {
+     *             double balanceA = co_await (a <= [](account& acc) { return acc.balance(); });
+     *             double balanceB = co_await (b <= [](account& acc) { return acc.balance(); });
+     *             co_return balanceA + balanceB;
+     *         }
+     *
+     *         If the coroutine was suspended on a worker of an executor, it is resumed on that executor. Otherwise, it is
+     *         resumed on the thread that provided the result, e.g. the worker thread of an async_object.
+     *         An exception stored in the future is rethrown by co_await.
+     *
+     *  \param R Type of the result.
+     *  \note Only available if the compiler supports C++20 coroutines (CONCURRENT_HAS_COROUTINES is defined).
+     */
+    template<typename R>
+    class future_awaiter
+    {
+        public:
+            explicit future_awaiter(future<R>&& f) : __future(std::move(f)) {}
+
+            bool await_ready() const
+            {
+                return this->__future.is_ready();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                // The coroutine may be resumed - and this awaiter destroyed - before on_ready() returns.
+                internal::future_access::slot(this->__future)->on_ready(internal::coroutine_resumption{ handle, executor::current() });
+            }
+
+            R await_resume()
+            {
+                return this->__future.get();
+            }
+
+        private:
+            future<R> __future;
+    };
+
+    /** \brief Makes a concurrent::future awaitable. Like get(), awaiting a future consumes it.
+     */
+    template<typename R>
+    future_awaiter<R> operator co_await(future<R>&& f)
+    {
+        return future_awaiter<R>(std::move(f));
+    }
+
+    template<typename R>
+    future_awaiter<R> operator co_await(future<R>& f)
+    {
+        return future_awaiter<R>(std::move(f));
+    }
+}
+
+/** \brief Lets coroutines return a concurrent::future<R>, so that they can be awaited (or waited for) in turn.
+ */
+template<typename R, typename... Args>
+struct std::coroutine_traits<concurrent::future<R>, Args...>
+{
+    typedef concurrent::internal::coroutine_promise<R> promise_type;
+};
+
+#endif // CONCURRENT_HAS_COROUTINES
+
+#endif // !__CONCURRENT_COROUTINE_HPP__
@@ -21,12 +21,14 @@ namespace concurrent
                 ptr_type __myVal;
                 Cloner __cloner;
 
-                void release()
+                /** \brief Gives this pointer a private copy of the value before it gets modified, unless it is the only owner.
+                 */
+                void detach()
                 {
                     T* tmp = this->__myVal.get();
-                    if (tmp != nullptr || this->__myVal.unique() )
+                    if (tmp != nullptr && this->__myVal.use_count() > 1)
                     {
-                        this->__myVal = ptr_type(cloner(tmp)); // copy tmp, since it may be deleted unrecognized otherwise
+                        this->__myVal = ptr_type(this->__cloner(tmp)); // copy tmp, since it may be deleted unrecognized otherwise
                     }
                 }
 
@@ -77,7 +79,7 @@ namespace concurrent
         template<typename T, typename C = cow::internal::defaultCloner<T>, typename... Args> 
         ptr<T, C> make_cow(Args&&... params)
         {
-            return ptr<T, C>(std::make_shared<T>(std::forward<Args&&...>(params...)));
+            return ptr<T, C>(std::make_shared<T>(std::forward<Args>(params)...));
         }
     }  
 }
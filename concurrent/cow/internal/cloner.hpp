@@ -1,18 +1,21 @@
 #ifndef __CLONER_HPP 
 #define __CLONER_HPP
 
-namespace cow
+namespace concurrent
 {
-    namespace internal 
+    namespace cow
     {
-        template<typename T>
-        struct defaultCloner
+        namespace internal 
         {
-            T* operator()(const T* const base)
+            template<typename T>
+            struct defaultCloner
             {
-                return new T(*base);
-            }
-        };        
+                T* operator()(const T* const base) const
+                {
+                    return new T(*base);
+                }
+            };        
+        }
     }
 }
 
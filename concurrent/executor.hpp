@@ -0,0 +1,209 @@
+#ifndef __CONCURRENT_EXECUTOR_HPP__
+#define __CONCURRENT_EXECUTOR_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrent/internal/block_pool.hpp"
+#include "concurrent/internal/cache_line.hpp"
+#include "concurrent/internal/waiter.hpp"
+#include "concurrent/task.hpp"
+#include "concurrent/wait_strategy.hpp"
+
+namespace concurrent
+{
+    /** \brief Fixed pool of worker threads that share their work by stealing. Every worker owns a task queue; tasks
+     *         submitted by a worker go to its own queue, tasks submitted from elsewhere are distributed round-robin.
+     *         A worker takes tasks from the front of its own queue and, once that one is empty, steals from the back of the
+     *         others. Idle workers park on an internal::waiter, so an idle pool does not burn CPU.
+     *
+     *         It is meant to carry many lightweight, serialized units of work (e.g. async_object strands) on a few threads:
+     *
+     *         concurrent::executor pool(4);
+     *         std::vector<std::unique_ptr<concurrent::async_object<session>>> sessions;
+     *         for (...) sessions.emplace_back(new concurrent::async_object<session>(pool));
+     *
+     *  \note Tasks are executed in no particular order and must not throw.
+     *  \note The executor has to outlive everything that submits tasks to it. On destruction, all pending tasks are run.
+     */
+    class executor
+    {
+        public:
+            typedef concurrent::task task_type;
+
+            /** \brief C'tor. Starts the worker threads.
+             *
+             * \param numThreads std::size_t Number of worker threads; 0 means one per hardware thread.
+             * \param strategy const wait_strategy& How idle workers wait for new tasks before they park.
+             */
+            explicit executor(std::size_t numThreads = 0, const wait_strategy& strategy = wait_strategy::balanced())
+                : __queues(numThreads > 0 ? numThreads : __hardware_threads()), __next(0), __stopping(false)
+            {
+                this->__idle.set_strategy(strategy);
+                this->__workers.reserve(this->__queues.size());
+                for (std::size_t i = 0; i < this->__queues.size(); ++i)
+                {
+                    this->__workers.emplace_back([this, i]() -> void { this->__work(i); });
+                }
+            }
+
+            /** \brief D'tor. Runs all pending tasks, including those submitted meanwhile, and joins the worker threads.
+             */
+            ~executor()
+            {
+                this->__stopping.store(true);
+                this->__idle.notify_all();
+                for (auto& worker : this->__workers)
+                {
+                    worker.join();
+                }
+            }
+
+            /** \brief Schedules a task for execution on one of the worker threads.
+             *
+             * \param task task_type Task to execute.
+             */
+            void submit(task_type task)
+            {
+                std::size_t index = __current_index(this);
+                if (index == no_worker)
+                {
+                    index = this->__next.fetch_add(1, std::memory_order_relaxed) % this->__queues.size();
+                }
+                {
+                    worker_queue& queue = this->__queues[index];
+                    std::lock_guard<std::mutex> lock(queue.lock);
+                    queue.tasks.push_back(std::move(task));
+                }
+                this->__idle.notify_one();
+            }
+
+            /** \brief Executes a single pending task on the calling thread, if there is any. Useful for a thread that has
+             *         to wait for a task of this executor without blocking a worker.
+             *
+             * \return bool "true" if a task was executed.
+             */
+            bool try_run_one()
+            {
+                std::size_t index = __current_index(this);
+                task_type task;
+                if (this->__try_take(index != no_worker ? index : 0, task))
+                {
+                    task();
+                    return true;
+                }
+                return false;
+            }
+
+            /** \brief Checks whether the calling thread is one of this executor's workers.
+             */
+            bool in_worker_thread() const
+            {
+                return __current_index(this) != no_worker;
+            }
+
+            std::size_t size() const
+            {
+                return this->__workers.size();
+            }
+
+            /** \brief Gets the executor the calling thread works for.
+             *
+             * \return executor* The executor, or nullptr if the calling thread is none's worker.
+             */
+            static executor* current()
+            {
+                return __current().first;
+            }
+
+        private:
+            // Prohibitions
+            executor(const executor& rhs);
+            executor& operator=(const executor& rhs);
+
+            static const std::size_t no_worker = static_cast<std::size_t>(-1);
+
+            struct alignas(cache_line_size) worker_queue
+            {
+                std::mutex lock;
+                std::deque<task_type, internal::pool_allocator<task_type>> tasks;
+            };
+
+            std::vector<worker_queue> __queues;                 /**< One queue per worker, indexed like __workers */
+            std::vector<std::thread> __workers;
+            std::atomic<std::size_t> __next;                    /**< Round-robin position for tasks submitted from outside */
+            std::atomic<bool> __stopping;
+            internal::waiter __idle;                            /**< Parking spot of idle workers */
+
+            static std::size_t __hardware_threads()
+            {
+                unsigned n = std::thread::hardware_concurrency();
+                return n > 0 ? n : 1;
+            }
+
+            /** \brief Registry of the executor the calling thread works for, and its index there.
+             */
+            static std::pair<executor*, std::size_t>& __current()
+            {
+                static thread_local std::pair<executor*, std::size_t> current(nullptr, no_worker);
+                return current;
+            }
+
+            static std::size_t __current_index(const executor* self)
+            {
+                const std::pair<executor*, std::size_t>& current = __current();
+                return current.first == self ? current.second : no_worker;
+            }
+
+            /** \brief Takes a task from the front of the given queue, or steals one from the back of another.
+             */
+            bool __try_take(std::size_t index, task_type& task)
+            {
+                std::size_t numQueues = this->__queues.size();
+                for (std::size_t i = 0; i < numQueues; ++i)
+                {
+                    worker_queue& queue = this->__queues[(index + i) % numQueues];
+                    std::lock_guard<std::mutex> lock(queue.lock);
+                    if (!queue.tasks.empty())
+                    {
+                        if (i == 0)
+                        {
+                            task = std::move(queue.tasks.front());
+                            queue.tasks.pop_front();
+                        }
+                        else
+                        {
+                            task = std::move(queue.tasks.back());
+                            queue.tasks.pop_back();
+                        }
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void __work(std::size_t index)
+            {
+                __current() = std::make_pair(this, index);
+                task_type task;
+                while (true)
+                {
+                    this->__idle.wait([&]() -> bool { return this->__try_take(index, task) || this->__stopping.load(); });
+                    if (!task)
+                    {
+                        return; // Stopping, and nothing left to do.
+                    }
+                    task();
+                    task = nullptr;
+                }
+            }
+    };
+}
+
+#endif // !__CONCURRENT_EXECUTOR_HPP__
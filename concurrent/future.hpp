@@ -0,0 +1,925 @@
+#ifndef __CONCURRENT_FUTURE_HPP__
+#define __CONCURRENT_FUTURE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concurrent/executor.hpp"
+#include "concurrent/task.hpp"
+#include "concurrent/internal/block_pool.hpp"
+#include "concurrent/internal/parking_lot.hpp"
+
+namespace concurrent
+{
+    template<typename R> class future;
+    template<typename R> class promise;
+
+    namespace internal
+    {
+        /** \brief Storage for the result of a result_slot, specialized for references and void.
+         */
+        template<typename R>
+        struct result_holder
+        {
+            template<typename... Args>
+            void construct(Args&&... args)
+            {
+                ::new (static_cast<void*>(this->storage)) R(std::forward<Args>(args)...);
+            }
+
+            R take()
+            {
+                return std::move(*this->value());
+            }
+
+            void destroy()
+            {
+                this->value()->~R();
+            }
+
+            R* value()
+            {
+                return reinterpret_cast<R*>(this->storage);
+            }
+
+            alignas(R) unsigned char storage[sizeof(R)];
+        };
+
+        template<typename R>
+        struct result_holder<R&>
+        {
+            void construct(R& r)
+            {
+                this->value = std::addressof(r);
+            }
+
+            R& take()
+            {
+                return *this->value;
+            }
+
+            void destroy() {}
+
+            R* value;
+        };
+
+        template<>
+        struct result_holder<void>
+        {
+            void construct() {}
+            void take() {}
+            void destroy() {}
+        };
+
+        /** \brief State shared by exactly one promise and one future. The result is published by a single atomic state change,
+         *         so checking for it and taking it never locks. Only a consumer that has to wait for a result which is not
+         *         there yet parks, on a shared internal::parking_lot spot; the producer only touches that spot if someone
+         *         is parked there. The slot itself lives in pooled memory.
+         */
+        template<typename R>
+        class result_slot
+        {
+            public:
+                static result_slot* create()
+                {
+                    return ::new (pool_allocate(sizeof(result_slot))) result_slot();
+                }
+
+                void add_ref()
+                {
+                    this->__refs.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                void release()
+                {
+                    if (this->__refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        this->~result_slot();
+                        pool_deallocate(this, sizeof(result_slot));
+                    }
+                }
+
+                template<typename... Args>
+                void set_value(Args&&... args)
+                {
+                    this->__holder.construct(std::forward<Args>(args)...);
+                    this->__hasValue = true;
+                    this->__publish();
+                }
+
+                void set_exception(std::exception_ptr e)
+                {
+                    this->__exception = e;
+                    this->__publish();
+                }
+
+                bool is_ready() const
+                {
+                    return this->__state.load(std::memory_order_acquire) == ready;
+                }
+
+                void wait() const
+                {
+                    if (!this->is_ready())
+                    {
+                        parking_lot(this).wait([this]() -> bool { return this->is_ready(); });
+                    }
+                }
+
+                template<typename Clock, typename Duration>
+                bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const
+                {
+                    return this->is_ready() || parking_lot(this).wait_until([this]() -> bool { return this->is_ready(); }, deadline);
+                }
+
+                /** \brief Hands out the result, or rethrows the exception. May only be called once the slot is ready.
+                 */
+                R take()
+                {
+                    if (this->__exception)
+                    {
+                        std::rethrow_exception(this->__exception);
+                    }
+                    return this->__holder.take();
+                }
+
+                /** \brief Registers a task that is run as soon as the result is available: either by the producer right after
+                 *         publishing it, or immediately by the calling thread if it already is. At most one per slot.
+                 */
+                void on_ready(task continuation)
+                {
+                    this->__continuation = ::new (pool_allocate(sizeof(task))) task(std::move(continuation));
+                    int expected = pending;
+                    if (!this->__state.compare_exchange_strong(expected, continued, std::memory_order_acq_rel, std::memory_order_acquire))
+                    {
+                        this->__run_continuation();
+                    }
+                }
+
+            private:
+                enum { pending, continued, ready };
+
+                result_slot() : __state(pending), __refs(1), __hasValue(false), __continuation(nullptr) {}
+
+                ~result_slot()
+                {
+                    if (this->__hasValue)
+                    {
+                        this->__holder.destroy();
+                    }
+                }
+
+                // Prohibitions
+                result_slot(const result_slot& rhs);
+                result_slot& operator=(const result_slot& rhs);
+
+                std::atomic<int> __state;
+                std::atomic<unsigned> __refs;
+                bool __hasValue;
+                std::exception_ptr __exception;
+                result_holder<R> __holder;
+                task* __continuation;                   /**< Only allocated if someone registered for the result */
+
+                void __publish()
+                {
+                    if (this->__state.exchange(ready, std::memory_order_acq_rel) == continued)
+                    {
+                        this->__run_continuation();
+                    }
+                    else
+                    {
+                        parking_lot(this).notify_all();
+                    }
+                }
+
+                void __run_continuation()
+                {
+                    task* continuation = this->__continuation;
+                    this->__continuation = nullptr;
+                    (*continuation)();
+                    continuation->~task();
+                    pool_deallocate(continuation, sizeof(task));
+                }
+        };
+
+        struct future_access;
+        template<typename Promise, typename R> struct result_bridge;
+        template<typename R, typename F, typename U> struct then_stage;
+        template<typename Stage> struct submit_stage;
+        template<typename Target, typename Stage> struct post_stage;
+
+        /** \brief Result type of a continuation that is called with Lead&... and the result of a future<R> (if not void).
+         */
+        template<typename R, typename F, typename... Lead>
+        struct continuation_result
+        {
+            typedef decltype(std::declval<F&>()(std::declval<Lead&>()..., std::declval<R>())) type;
+        };
+
+        template<typename F, typename... Lead>
+        struct continuation_result<void, F, Lead...>
+        {
+            typedef decltype(std::declval<F&>()(std::declval<Lead&>()...)) type;
+        };
+
+        /** \brief A continuation that returns a future<V> yields a future<V> as well, not a future<future<V>>.
+         */
+        template<typename U>
+        struct unwrapped
+        {
+            typedef U type;
+        };
+
+        template<typename V>
+        struct unwrapped< future<V> >
+        {
+            typedef V type;
+        };
+    }
+
+    /** \brief Lightweight counterpart of std::future for a result that is produced by a single thread and consumed by a single
+     *         thread, as returned by async_object. Checking for the result (is_ready()) is a single atomic load, and
+     *         get() of an available result neither locks nor allocates. The shared state is pooled.
+     *         Where a std::future is needed, it converts to one (at the price of a std::promise).
+     *         Instead of blocking on the result, work can be chained onto it with then(), and several futures can be joined
+     *         with when_all() and when_any():
+     *
+     *         (account <= [](account& a) { return a.balance(); })
+     *             .then(ledger, [](ledger& l, double balance) { l.record(balance); });
+     *
+     *  \param R Type of the result.
+     */
+    template<typename R>
+    class future
+    {
+        public:
+            future() : __slot(nullptr) {}
+
+            future(future&& rhs) : __slot(rhs.__slot)
+            {
+                rhs.__slot = nullptr;
+            }
+
+            future& operator=(future&& rhs)
+            {
+                if (this != &rhs)
+                {
+                    this->__reset();
+                    this->__slot = rhs.__slot;
+                    rhs.__slot = nullptr;
+                }
+                return *this;
+            }
+
+            ~future()
+            {
+                this->__reset();
+            }
+
+            /** \brief Checks whether the future refers to a result, i.e. whether get() has not been called yet.
+             */
+            bool valid() const
+            {
+                return this->__slot != nullptr;
+            }
+
+            /** \brief Checks whether the result is available, so get() would not block.
+             */
+            bool is_ready() const
+            {
+                return this->__slot != nullptr && this->__slot->is_ready();
+            }
+
+            /** \brief Waits for the result and hands it out. Afterwards, the future is no longer valid.
+             *
+             * \return R The result. If the producer stored an exception instead, it is rethrown.
+             */
+            R get()
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                slot_reference slot(this->__slot);
+                this->__slot = nullptr;
+                slot.ptr->wait();
+                return slot.ptr->take();
+            }
+
+            void wait() const
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                this->__slot->wait();
+            }
+
+            template<typename Rep, typename Period>
+            std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+            {
+                return this->wait_until(std::chrono::steady_clock::now() + timeout);
+            }
+
+            template<typename Clock, typename Duration>
+            std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                return this->__slot->wait_until(deadline) ? std::future_status::ready : std::future_status::timeout;
+            }
+
+            /** \brief Converts into a std::future for the same result. Afterwards, this future is no longer valid.
+             */
+            operator std::future<R>() &&
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                std::promise<R> target;
+                std::future<R> result = target.get_future();
+                internal::result_slot<R>* slot = this->__slot;
+                slot->on_ready(internal::result_bridge<std::promise<R>, R>{ std::move(*this), std::move(target) });
+                return result;
+            }
+
+            /** \brief Attaches a continuation that is called with the result as soon as it is available, on the thread that
+             *         provides it (e.g. the worker of the async_object that produced it), or right away if it already is.
+             *         Afterwards, this future is no longer valid.
+             *
+             * \param f F Continuation, called with R (or without arguments for future<void>). It should be short, since it
+             *          delays whatever the producing thread would do next.
+             * \return future<U> Future for the continuation's result U. If the continuation returns a future<V>, the result is
+             *         a future<V> as well. If this future holds an exception, the continuation is skipped and the exception is
+             *         passed on.
+             */
+            template<typename F>
+            auto then(F&& f) -> future<typename internal::unwrapped<typename internal::continuation_result<R, typename std::decay<F>::type>::type>::type>
+            {
+                typedef typename internal::continuation_result<R, typename std::decay<F>::type>::type result_type;
+                return this->template __then<result_type>(std::forward<F>(f), inline_stage());
+            }
+
+            /** \brief Attaches a continuation that is submitted to the given executor as soon as the result is available.
+             *
+             * \param ex executor& Executor to run the continuation on.
+             * \param f F Continuation, called with R (or without arguments for future<void>).
+             * \return future<U> See then(F&&).
+             */
+            template<typename F>
+            auto then(executor& ex, F&& f) -> future<typename internal::unwrapped<typename internal::continuation_result<R, typename std::decay<F>::type>::type>::type>
+            {
+                typedef typename internal::continuation_result<R, typename std::decay<F>::type>::type result_type;
+                return this->template __then<result_type>(std::forward<F>(f), submit_stage(ex));
+            }
+
+            /** \brief Attaches a continuation that is posted to the given target - e.g. an async_object - as soon as the result is
+             *         available. It is executed in order with the target's other functors and gets access to its value.
+             *
+             * \param target Target& Object offering value_type and post(g), where g is called with value_type&.
+             * \param f F Continuation, called with value_type& and R (only value_type& for future<void>).
+             * \return future<U> See then(F&&).
+             */
+            template<typename Target, typename F>
+            auto then(Target& target, F&& f) -> future<typename internal::unwrapped<typename internal::continuation_result<R, typename std::decay<F>::type, typename Target::value_type>::type>::type>
+            {
+                typedef typename internal::continuation_result<R, typename std::decay<F>::type, typename Target::value_type>::type result_type;
+                return this->template __then<result_type>(std::forward<F>(f), post_stage<Target>(target));
+            }
+
+        private:
+            friend class promise<R>;
+            friend struct internal::future_access;
+
+            // Prohibitions
+            future(const future& rhs);
+            future& operator=(const future& rhs);
+
+            /** \brief Releases the slot when leaving get(), after the result has been taken (or thrown).
+             */
+            struct slot_reference
+            {
+                explicit slot_reference(internal::result_slot<R>* slot) : ptr(slot) {}
+                ~slot_reference()
+                {
+                    this->ptr->release();
+                }
+
+                internal::result_slot<R>* ptr;
+            };
+
+            internal::result_slot<R>* __slot;
+
+            explicit future(internal::result_slot<R>* slot) : __slot(slot) {}
+
+            /** \brief Ways to get a then_stage running once the result is available.
+             */
+            struct inline_stage
+            {
+                template<typename Stage>
+                Stage operator()(Stage&& stage) const
+                {
+                    return std::move(stage);
+                }
+            };
+
+            struct submit_stage
+            {
+                explicit submit_stage(executor& ex) : target(&ex) {}
+
+                template<typename Stage>
+                internal::submit_stage<Stage> operator()(Stage&& stage) const
+                {
+                    return internal::submit_stage<Stage>{ this->target, std::move(stage) };
+                }
+
+                executor* target;
+            };
+
+            template<typename Target>
+            struct post_stage
+            {
+                explicit post_stage(Target& t) : target(&t) {}
+
+                template<typename Stage>
+                internal::post_stage<Target, Stage> operator()(Stage&& stage) const
+                {
+                    return internal::post_stage<Target, Stage>{ this->target, std::move(stage) };
+                }
+
+                Target* target;
+            };
+
+            template<typename U, typename F, typename Schedule>
+            future<typename internal::unwrapped<U>::type> __then(F&& f, Schedule schedule)
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                typedef internal::then_stage<R, typename std::decay<F>::type, U> stage_type;
+                promise<typename internal::unwrapped<U>::type> next;
+                future<typename internal::unwrapped<U>::type> result = next.get_future();
+                internal::result_slot<R>* slot = this->__slot;
+                slot->on_ready(schedule(stage_type{ std::move(*this), std::move(next), std::forward<F>(f) }));
+                return result;
+            }
+
+            void __reset()
+            {
+                if (this->__slot != nullptr)
+                {
+                    this->__slot->release();
+                    this->__slot = nullptr;
+                }
+            }
+    };
+
+    /** \brief Producer side of a concurrent::future. If it is destroyed without a result, the future receives a
+     *         std::future_error with std::future_errc::broken_promise, like std::promise does.
+     *
+     *  \param R Type of the result.
+     */
+    template<typename R>
+    class promise
+    {
+        public:
+            promise() : __slot(internal::result_slot<R>::create()), __retrieved(false), __satisfied(false) {}
+
+            promise(promise&& rhs) : __slot(rhs.__slot), __retrieved(rhs.__retrieved), __satisfied(rhs.__satisfied)
+            {
+                rhs.__slot = nullptr;
+            }
+
+            promise& operator=(promise&& rhs)
+            {
+                if (this != &rhs)
+                {
+                    this->__abandon();
+                    this->__slot = rhs.__slot;
+                    this->__retrieved = rhs.__retrieved;
+                    this->__satisfied = rhs.__satisfied;
+                    rhs.__slot = nullptr;
+                }
+                return *this;
+            }
+
+            ~promise()
+            {
+                this->__abandon();
+            }
+
+            /** \brief Returns the future for the result. May only be called once.
+             */
+            future<R> get_future()
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                if (this->__retrieved)
+                {
+                    throw std::future_error(std::future_errc::future_already_retrieved);
+                }
+                this->__retrieved = true;
+                this->__slot->add_ref();
+                return future<R>(this->__slot);
+            }
+
+            /** \brief Stores the result and wakes up the consumer, if it waits.
+             *
+             * \param args Args&&... Arguments to construct the result from; none for promise<void>.
+             */
+            template<typename... Args>
+            void set_value(Args&&... args)
+            {
+                this->__check_unsatisfied();
+                this->__satisfied = true;
+                this->__slot->set_value(std::forward<Args>(args)...);
+            }
+
+            void set_exception(std::exception_ptr e)
+            {
+                this->__check_unsatisfied();
+                this->__satisfied = true;
+                this->__slot->set_exception(e);
+            }
+
+        private:
+            // Prohibitions
+            promise(const promise& rhs);
+            promise& operator=(const promise& rhs);
+
+            internal::result_slot<R>* __slot;
+            bool __retrieved;
+            bool __satisfied;
+
+            void __check_unsatisfied() const
+            {
+                if (this->__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                if (this->__satisfied)
+                {
+                    throw std::future_error(std::future_errc::promise_already_satisfied);
+                }
+            }
+
+            void __abandon()
+            {
+                if (this->__slot != nullptr)
+                {
+                    if (!this->__satisfied && this->__retrieved)
+                    {
+                        this->__slot->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+                    }
+                    this->__slot->release();
+                    this->__slot = nullptr;
+                }
+            }
+    };
+    namespace internal
+    {
+        /** \brief Access to the result slot of a future, for the combinators below.
+         */
+        struct future_access
+        {
+            template<typename R>
+            static result_slot<R>* slot(future<R>& f)
+            {
+                if (f.__slot == nullptr)
+                {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                return f.__slot;
+            }
+        };
+
+        template<template<typename> class Promise, typename R>
+        void forward_result(Promise<R>& p, future<R>& f)
+        {
+            p.set_value(f.get());
+        }
+
+        template<template<typename> class Promise>
+        void forward_result(Promise<void>& p, future<void>& f)
+        {
+            f.get();
+            p.set_value();
+        }
+
+        /** \brief Continuation that passes the result of a (ready) future on to a promise, e.g. a std::promise.
+         */
+        template<typename Promise, typename R>
+        struct result_bridge
+        {
+            future<R> source;
+            Promise target;
+
+            void operator()()
+            {
+                try
+                {
+                    forward_result(this->target, this->source);
+                }
+                catch (...)
+                {
+                    this->target.set_exception(std::current_exception());
+                }
+            }
+        };
+
+        /** \brief Fulfils a promise with the result of calling a continuation, depending on the continuation's result type U.
+         */
+        template<typename U>
+        struct completer
+        {
+            template<typename V, typename F, typename... Args>
+            static void complete(promise<V>& p, F& f, Args&&... args)
+            {
+                p.set_value(f(std::forward<Args>(args)...));
+            }
+        };
+
+        template<>
+        struct completer<void>
+        {
+            template<typename F, typename... Args>
+            static void complete(promise<void>& p, F& f, Args&&... args)
+            {
+                f(std::forward<Args>(args)...);
+                p.set_value();
+            }
+        };
+
+        template<typename V>
+        struct completer< future<V> >
+        {
+            template<typename F, typename... Args>
+            static void complete(promise<V>& p, F& f, Args&&... args)
+            {
+                future<V> inner = f(std::forward<Args>(args)...);
+                result_slot<V>* slot = future_access::slot(inner);
+                slot->on_ready(result_bridge<promise<V>, V>{ std::move(inner), std::move(p) });
+            }
+        };
+
+        /** \brief A continuation together with the future it waits for and the promise for its own result. Called without
+         *         arguments when run inline or on an executor, and with the target's value when posted to a target.
+         */
+        template<typename R, typename F, typename U>
+        struct then_stage
+        {
+            future<R> antecedent;
+            promise<typename unwrapped<U>::type> result;
+            F f;
+
+            void operator()()
+            {
+                this->__run();
+            }
+
+            template<typename V>
+            void operator()(V& value)
+            {
+                this->__run(value);
+            }
+
+            template<typename... Lead>
+            void __run(Lead&... lead)
+            {
+                try
+                {
+                    this->__invoke(std::is_void<R>(), lead...);
+                }
+                catch (...)
+                {
+                    this->result.set_exception(std::current_exception());
+                }
+            }
+
+            template<typename... Lead>
+            void __invoke(std::false_type /* value */, Lead&... lead)
+            {
+                completer<U>::complete(this->result, this->f, lead..., this->antecedent.get());
+            }
+
+            template<typename... Lead>
+            void __invoke(std::true_type /* void */, Lead&... lead)
+            {
+                this->antecedent.get();
+                completer<U>::complete(this->result, this->f, lead...);
+            }
+        };
+
+        template<typename Stage>
+        struct submit_stage
+        {
+            executor* target;
+            Stage stage;
+
+            void operator()()
+            {
+                this->target->submit(std::move(this->stage));
+            }
+        };
+
+        template<typename Target, typename Stage>
+        struct post_stage
+        {
+            Target* target;
+            Stage stage;
+
+            void operator()()
+            {
+                this->target->post(std::move(this->stage));
+            }
+        };
+
+        template<typename Future>
+        struct future_result;
+
+        template<typename R>
+        struct future_result< future<R> >
+        {
+            typedef R type;
+        };
+
+        template<typename R>
+        struct when_all_state
+        {
+            explicit when_all_state(std::size_t numFutures) : remaining(numFutures + 1)
+            {
+                this->futures.reserve(numFutures);
+            }
+
+            /** \brief Counts down; the last one to arrive fulfils the promise. The setup counts as one, so that the result
+             *         cannot be set while the continuations are still being attached.
+             */
+            void arrive()
+            {
+                if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    this->result.set_value(std::move(this->futures));
+                }
+            }
+
+            std::vector<future<R>> futures;
+            std::atomic<std::size_t> remaining;
+            promise<std::vector<future<R>>> result;
+        };
+
+        template<typename R>
+        struct when_all_arrival
+        {
+            std::shared_ptr<when_all_state<R>> state;
+
+            void operator()()
+            {
+                this->state->arrive();
+            }
+        };
+    }
+
+    /** \brief Result of when_any(): the futures, and the index of the one that was ready first.
+     */
+    template<typename Sequence>
+    struct when_any_result
+    {
+        std::size_t index;                  /**< static_cast<std::size_t>(-1) if the sequence is empty */
+        Sequence futures;
+    };
+
+    namespace internal
+    {
+        template<typename R>
+        struct when_any_state
+        {
+            when_any_state() : done(false) {}
+
+            std::vector<future<R>> futures;
+            std::atomic<bool> done;
+            promise<when_any_result<std::vector<future<R>>>> result;
+        };
+
+        /** \brief Passes the result of one of the original futures on to the future handed out by when_any(), and fulfils
+         *         the when_any() promise if it is the first one to do so.
+         */
+        template<typename R>
+        struct when_any_arrival
+        {
+            std::shared_ptr<when_any_state<R>> state;
+            std::size_t index;
+            future<R> source;
+            promise<R> target;
+
+            void operator()()
+            {
+                try
+                {
+                    forward_result(this->target, this->source);
+                }
+                catch (...)
+                {
+                    this->target.set_exception(std::current_exception());
+                }
+                if (!this->state->done.exchange(true, std::memory_order_acq_rel))
+                {
+                    when_any_result<std::vector<future<R>>> first = { this->index, std::move(this->state->futures) };
+                    this->state->result.set_value(std::move(first));
+                }
+            }
+        };
+    }
+
+    /** \brief Joins a range of futures without blocking any thread: the returned future becomes ready once all of them are.
+     *         The futures are moved out of the range.
+     *
+     * \param first InputIt Begin of the range of concurrent::future<R>.
+     * \param last InputIt End of the range.
+     * \return future<std::vector<future<R>>> All futures, in order and ready; each one holds a result or an exception.
+     */
+    template<typename InputIt>
+    future<std::vector<typename std::iterator_traits<InputIt>::value_type>> when_all(InputIt first, InputIt last)
+    {
+        typedef typename internal::future_result<typename std::iterator_traits<InputIt>::value_type>::type result_type;
+        std::shared_ptr<internal::when_all_state<result_type>> state =
+            std::allocate_shared<internal::when_all_state<result_type>>(internal::pool_allocator<internal::when_all_state<result_type>>(),
+                                                                        static_cast<std::size_t>(std::distance(first, last)));
+        for (; first != last; ++first)
+        {
+            state->futures.push_back(std::move(*first));
+        }
+        future<std::vector<future<result_type>>> result = state->result.get_future();
+        for (auto& f : state->futures)
+        {
+            internal::future_access::slot(f)->on_ready(internal::when_all_arrival<result_type>{ state });
+        }
+        state->arrive();
+        return result;
+    }
+
+    template<typename R>
+    future<std::vector<future<R>>> when_all(std::vector<future<R>>& futures)
+    {
+        return when_all(futures.begin(), futures.end());
+    }
+
+    /** \brief Waits for the first of a range of futures without blocking any thread. The futures are moved out of the range;
+     *         the returned ones deliver the same results.
+     *
+     * \param first InputIt Begin of the range of concurrent::future<R>.
+     * \param last InputIt End of the range.
+     * \return future<when_any_result<std::vector<future<R>>>> All futures, in order, and the index of one that is ready.
+     */
+    template<typename InputIt>
+    future<when_any_result<std::vector<typename std::iterator_traits<InputIt>::value_type>>> when_any(InputIt first, InputIt last)
+    {
+        typedef typename internal::future_result<typename std::iterator_traits<InputIt>::value_type>::type result_type;
+        std::shared_ptr<internal::when_any_state<result_type>> state =
+            std::allocate_shared<internal::when_any_state<result_type>>(internal::pool_allocator<internal::when_any_state<result_type>>());
+        future<when_any_result<std::vector<future<result_type>>>> result = state->result.get_future();
+        std::vector<future<result_type>> sources;
+        std::vector<promise<result_type>> targets;
+        for (; first != last; ++first)
+        {
+            sources.push_back(std::move(*first));
+            targets.push_back(promise<result_type>());
+            state->futures.push_back(targets.back().get_future());
+        }
+        if (sources.empty())
+        {
+            when_any_result<std::vector<future<result_type>>> none = { static_cast<std::size_t>(-1), std::vector<future<result_type>>() };
+            state->result.set_value(std::move(none));
+            return result;
+        }
+        // All futures to hand out exist now, so the first arrival may take them.
+        for (std::size_t i = 0; i < sources.size(); ++i)
+        {
+            internal::result_slot<result_type>* slot = internal::future_access::slot(sources[i]);
+            slot->on_ready(internal::when_any_arrival<result_type>{ state, i, std::move(sources[i]), std::move(targets[i]) });
+        }
+        return result;
+    }
+
+    template<typename R>
+    future<when_any_result<std::vector<future<R>>>> when_any(std::vector<future<R>>& futures)
+    {
+        return when_any(futures.begin(), futures.end());
+    }
+}
+
+#endif // !__CONCURRENT_FUTURE_HPP__
@@ -0,0 +1,93 @@
+#ifndef __CONCURRENT_INTERNAL_BATCH_COUNTER_HPP__
+#define __CONCURRENT_INTERNAL_BATCH_COUNTER_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace concurrent
+{
+    /** \brief Snapshot of the batches an async_object executed its functors in.
+     */
+    struct batch_statistics
+    {
+        static const std::size_t num_buckets = 8;
+
+        std::uint64_t batches;                              /**< Number of batches executed */
+        std::uint64_t tasks;                                /**< Number of functors executed in them */
+        std::uint64_t largest;                              /**< Size of the largest batch */
+        std::array<std::uint64_t, num_buckets> sizes;       /**< Number of batches of 1, 2-3, 4-7, ..., 64-127 and 128 or more functors */
+
+        double average() const
+        {
+            return this->batches > 0 ? static_cast<double>(this->tasks) / this->batches : 0.0;
+        }
+    };
+
+    namespace internal
+    {
+        /** \brief Records batch sizes. Written by a single thread at a time (the one that executes the batches), read by any.
+         */
+        class batch_counter
+        {
+            public:
+                batch_counter() : __batches(0), __tasks(0), __largest(0)
+                {
+                    for (auto& bucket : this->__sizes)
+                    {
+                        bucket.store(0, std::memory_order_relaxed);
+                    }
+                }
+
+                void record(std::size_t batchSize)
+                {
+                    __increment(this->__batches, 1);
+                    __increment(this->__tasks, batchSize);
+                    if (batchSize > this->__largest.load(std::memory_order_relaxed))
+                    {
+                        this->__largest.store(batchSize, std::memory_order_relaxed);
+                    }
+                    std::size_t bucket = 0;
+                    while (batchSize > 1 && bucket + 1 < batch_statistics::num_buckets)
+                    {
+                        batchSize >>= 1;
+                        ++bucket;
+                    }
+                    __increment(this->__sizes[bucket], 1);
+                }
+
+                batch_statistics snapshot() const
+                {
+                    batch_statistics result;
+                    result.batches = this->__batches.load(std::memory_order_relaxed);
+                    result.tasks = this->__tasks.load(std::memory_order_relaxed);
+                    result.largest = this->__largest.load(std::memory_order_relaxed);
+                    for (std::size_t i = 0; i < batch_statistics::num_buckets; ++i)
+                    {
+                        result.sizes[i] = this->__sizes[i].load(std::memory_order_relaxed);
+                    }
+                    return result;
+                }
+
+            private:
+                // Prohibitions
+                batch_counter(const batch_counter& rhs);
+                batch_counter& operator=(const batch_counter& rhs);
+
+                std::atomic<std::uint64_t> __batches;
+                std::atomic<std::uint64_t> __tasks;
+                std::atomic<std::uint64_t> __largest;
+                std::array<std::atomic<std::uint64_t>, batch_statistics::num_buckets> __sizes;
+
+                /** \brief Single-writer increment, cheaper than fetch_add.
+                 */
+                static void __increment(std::atomic<std::uint64_t>& counter, std::uint64_t n)
+                {
+                    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+                }
+        };
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_BATCH_COUNTER_HPP__
@@ -0,0 +1,197 @@
+#ifndef __CONCURRENT_INTERNAL_BLOCK_POOL_HPP__
+#define __CONCURRENT_INTERNAL_BLOCK_POOL_HPP__
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <queue>
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Process-wide free list of memory blocks of one size. Freed blocks are kept and handed out again, so code that
+         *         allocates and frees blocks of the same size at a steady rate (like tasks travelling through a queue) stops
+         *         hitting malloc once it has warmed up.
+         *         Every thread keeps a small cache of free blocks; the shared list behind it is only locked to exchange
+         *         a batch of blocks with such a cache, which keeps threads from fighting over a lock on every call.
+         *
+         *  \note Memory is never returned to the system; the pool keeps as many blocks as were in use at the same time at most.
+         */
+        template<std::size_t BlockSize>
+        class block_pool
+        {
+            static_assert( BlockSize >= sizeof(void*) && BlockSize % alignof(std::max_align_t) == 0, "Blocks have to be able to hold a pointer and keep their alignment!" );
+
+            public:
+                static const std::size_t block_size = BlockSize;
+
+                static void* allocate()
+                {
+                    cache& local = __local_cache();
+                    if (local.head == nullptr)
+                    {
+                        __shared().refill(local);
+                    }
+                    node* block = local.head;
+                    local.head = block->next;
+                    --local.count;
+                    return block;
+                }
+
+                static void deallocate(void* p)
+                {
+                    cache& local = __local_cache();
+                    node* block = static_cast<node*>(p);
+                    block->next = local.head;
+                    local.head = block;
+                    if (++local.count > 2 * batch_size)
+                    {
+                        __shared().give_back(local, batch_size);
+                    }
+                }
+
+            private:
+                static const std::size_t batch_size = 32;        /**< Number of blocks exchanged between a thread's cache and the shared list at once */
+
+                struct node
+                {
+                    node* next;
+                };
+
+                struct cache;
+
+                /** \brief The shared list, plus the chunks of memory the blocks are carved from.
+                 */
+                struct shared_list
+                {
+                    shared_list() : head(nullptr) {}
+
+                    void refill(cache& local)
+                    {
+                        std::lock_guard<std::mutex> lock(this->mutex);
+                        if (this->head == nullptr)
+                        {
+                            char* chunk = static_cast<char*>(::operator new(batch_size * BlockSize));
+                            for (std::size_t i = 0; i < batch_size; ++i)
+                            {
+                                node* block = reinterpret_cast<node*>(chunk + i * BlockSize);
+                                block->next = this->head;
+                                this->head = block;
+                            }
+                        }
+                        for (std::size_t i = 0; i < batch_size && this->head != nullptr; ++i)
+                        {
+                            node* block = this->head;
+                            this->head = block->next;
+                            block->next = local.head;
+                            local.head = block;
+                            ++local.count;
+                        }
+                    }
+
+                    void give_back(cache& local, std::size_t count)
+                    {
+                        std::lock_guard<std::mutex> lock(this->mutex);
+                        for (std::size_t i = 0; i < count && local.head != nullptr; ++i)
+                        {
+                            node* block = local.head;
+                            local.head = block->next;
+                            --local.count;
+                            block->next = this->head;
+                            this->head = block;
+                        }
+                    }
+
+                    std::mutex mutex;
+                    node* head;
+                };
+
+                /** \brief Per-thread cache. Its blocks are handed back to the shared list when the thread exits.
+                 */
+                struct cache
+                {
+                    cache() : head(nullptr), count(0) {}
+                    ~cache()
+                    {
+                        __shared().give_back(*this, this->count);
+                    }
+
+                    node* head;
+                    std::size_t count;
+                };
+
+                static shared_list& __shared()
+                {
+                    static shared_list* list = new shared_list(); // Never destroyed: thread caches may hand back blocks during static destruction.
+                    return *list;
+                }
+
+                static cache& __local_cache()
+                {
+                    static thread_local cache local;
+                    return local;
+                }
+        };
+
+        /** \brief Allocates memory of the given size from the smallest fitting block_pool, or from the global operator new if
+         *         it is larger than the largest block. The memory is suitably aligned for anything but over-aligned types.
+         *
+         * \param bytes std::size_t Number of bytes required.
+         * \return void* Memory, to be released with pool_deallocate() and the same size.
+         */
+        inline void* pool_allocate(std::size_t bytes)
+        {
+            if (bytes <= 64) return block_pool<64>::allocate();
+            if (bytes <= 128) return block_pool<128>::allocate();
+            if (bytes <= 256) return block_pool<256>::allocate();
+            if (bytes <= 512) return block_pool<512>::allocate();
+            if (bytes <= 1024) return block_pool<1024>::allocate();
+            return ::operator new(bytes);
+        }
+
+        inline void pool_deallocate(void* p, std::size_t bytes)
+        {
+            if (bytes <= 64) block_pool<64>::deallocate(p);
+            else if (bytes <= 128) block_pool<128>::deallocate(p);
+            else if (bytes <= 256) block_pool<256>::deallocate(p);
+            else if (bytes <= 512) block_pool<512>::deallocate(p);
+            else if (bytes <= 1024) block_pool<1024>::deallocate(p);
+            else ::operator delete(p);
+        }
+
+        /** \brief Stateless allocator on top of pool_allocate(), e.g. for the shared state of a std::promise or the nodes of a
+         *         std::deque.
+         */
+        template<typename T>
+        struct pool_allocator
+        {
+            typedef T value_type;
+
+            pool_allocator() {}
+            template<typename U> pool_allocator(const pool_allocator<U>&) {}
+
+            T* allocate(std::size_t n)
+            {
+                static_assert( alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported!" );
+                return static_cast<T*>(pool_allocate(n * sizeof(T)));
+            }
+
+            void deallocate(T* p, std::size_t n)
+            {
+                pool_deallocate(p, n * sizeof(T));
+            }
+
+            template<typename U> bool operator==(const pool_allocator<U>&) const { return true; }
+            template<typename U> bool operator!=(const pool_allocator<U>&) const { return false; }
+        };
+
+        /** \brief std::queue whose nodes are taken from the block pools, usable as Storage of concurrent::queue.
+         */
+        template<typename T, typename...>
+        using pooled_queue = std::queue<T, std::deque<T, pool_allocator<T>>>;
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_BLOCK_POOL_HPP__
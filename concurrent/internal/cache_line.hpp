@@ -0,0 +1,11 @@
+#ifndef __CONCURRENT_INTERNAL_CACHE_LINE_HPP__
+#define __CONCURRENT_INTERNAL_CACHE_LINE_HPP__
+
+#include <cstddef>
+
+namespace concurrent
+{
+    static const std::size_t cache_line_size = 64;  /**< Assumed size of a cache line, used to keep independently modified data apart */
+}
+
+#endif // !__CONCURRENT_INTERNAL_CACHE_LINE_HPP__
@@ -0,0 +1,125 @@
+#ifndef __CONCURRENT_INTERNAL_PARKING_CONDITION_HPP__
+#define __CONCURRENT_INTERNAL_PARKING_CONDITION_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "concurrent/wait_strategy.hpp"
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Drop-in replacement for std::condition_variable in the locking queue and channel, offering the same
+         *         wait/wait_until/notify interface. Two things differ:
+         *         - Before a thread gets parked, it releases the lock and spins/yields according to its wait_strategy,
+         *           watching a change counter that every notification bumps. Only if nothing happened in the meantime,
+         *           it sleeps on the condition variable.
+         *         - Notifications only signal the condition variable if a thread is actually parked on it, so the
+         *           common case of a producer running ahead of its consumers never performs a syscall.
+         *  \note All functions have to be called while holding the mutex that protects the waited-for state; the
+         *        number of parked threads is protected by it as well.
+         */
+        class parking_condition
+        {
+            public:
+                parking_condition() : __strategy(wait_strategy::balanced()), __epoch(0), __parked(0) {}
+
+                void set_strategy(const wait_strategy& strategy)
+                {
+                    this->__strategy = strategy;
+                }
+
+                const wait_strategy& strategy() const
+                {
+                    return this->__strategy;
+                }
+
+                /** \brief Blocks until pred() returns true.
+                 *
+                 * \param lock std::unique_lock<std::mutex>& Lock on the mutex that protects the state pred() checks.
+                 * \param pred Pred Condition to wait for.
+                 */
+                template<typename Pred>
+                void wait(std::unique_lock<std::mutex>& lock, Pred pred)
+                {
+                    if (pred() || (this->__spin(lock) && pred()))
+                    {
+                        return;
+                    }
+                    ++this->__parked;
+                    this->__condition.wait(lock, pred);
+                    --this->__parked;
+                }
+
+                /** \brief Blocks until pred() returns true or the deadline passed.
+                 *
+                 * \return bool Result of the last evaluation of pred().
+                 */
+                template<typename Clock, typename Duration, typename Pred>
+                bool wait_until(std::unique_lock<std::mutex>& lock, const std::chrono::time_point<Clock, Duration>& deadline, Pred pred)
+                {
+                    if (pred() || (this->__spin(lock) && pred()))
+                    {
+                        return true;
+                    }
+                    ++this->__parked;
+                    bool result = this->__condition.wait_until(lock, deadline, pred);
+                    --this->__parked;
+                    return result;
+                }
+
+                void notify_one()
+                {
+                    this->__epoch.fetch_add(1, std::memory_order_relaxed);
+                    if (this->__parked > 0)
+                    {
+                        this->__condition.notify_one();
+                    }
+                }
+
+                void notify_all()
+                {
+                    this->__epoch.fetch_add(1, std::memory_order_relaxed);
+                    if (this->__parked > 0)
+                    {
+                        this->__condition.notify_all();
+                    }
+                }
+
+            private:
+                // Prohibitions
+                parking_condition(const parking_condition& rhs);
+                parking_condition& operator=(const parking_condition& rhs);
+
+                std::condition_variable __condition;
+                wait_strategy __strategy;
+                std::atomic<unsigned> __epoch;      /**< Bumped by every notification, watched by spinning threads */
+                unsigned __parked;                  /**< Number of threads sleeping on __condition; protected by the caller's mutex */
+
+                /** \brief Releases the lock while spinning on the change counter.
+                 *
+                 * \return bool "true" if a notification happened meanwhile; the lock is held again in any case.
+                 */
+                bool __spin(std::unique_lock<std::mutex>& lock)
+                {
+                    if (this->__strategy.spin_count == 0 && this->__strategy.yield_count == 0)
+                    {
+                        return false;
+                    }
+                    unsigned seen = this->__epoch.load(std::memory_order_relaxed);
+                    lock.unlock();
+                    bool changed = this->__strategy.spin([&]()->bool
+                    {
+                        return this->__epoch.load(std::memory_order_relaxed) != seen;
+                    });
+                    lock.lock();
+                    return changed;
+                }
+        };
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_PARKING_CONDITION_HPP__
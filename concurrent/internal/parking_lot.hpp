@@ -0,0 +1,30 @@
+#ifndef __CONCURRENT_INTERNAL_PARKING_LOT_HPP__
+#define __CONCURRENT_INTERNAL_PARKING_LOT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "concurrent/internal/cache_line.hpp"
+#include "concurrent/internal/waiter.hpp"
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Shared parking spots for small objects that cannot afford a waiter of their own, like the result slot of every
+         *         concurrent::future. The waiter is picked by the object's address; objects that end up on the same one only
+         *         cause spurious wakeups, which their waiters tolerate by re-checking their condition anyway.
+         *
+         * \param address const void* Address of the object to wait for.
+         * \return waiter& Waiter to wait on and notify for this object.
+         */
+        inline waiter& parking_lot(const void* address)
+        {
+            static const std::size_t numSpots = 64;
+            static waiter spots[numSpots];
+            return spots[(reinterpret_cast<std::uintptr_t>(address) / cache_line_size) % numSpots];
+        }
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_PARKING_LOT_HPP__
@@ -0,0 +1,80 @@
+#ifndef __CONCURRENT_INTERNAL_SELECT_WAITER_HPP__
+#define __CONCURRENT_INTERNAL_SELECT_WAITER_HPP__
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Wakeup slot shared by all channels a concurrent::select is waiting on. Each of these channels keeps a pointer
+         *         to it while the select is blocked and signals it whenever its state changes (message added or taken, channel closed).
+         *         A signal that arrives while nobody waits is kept until the next wait().
+         */
+        class select_waiter
+        {
+            public:
+                select_waiter() : __signaled(false) {}
+
+                void notify()
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+                    this->__signaled = true;
+                    this->__condition.notify_one();
+                }
+
+                void wait()
+                {
+                    std::unique_lock<std::mutex> lock(this->__mutex);
+                    this->__condition.wait(lock, [this]()->bool { return this->__signaled; });
+                    this->__signaled = false;
+                }
+
+            private:
+                // Prohibitions
+                select_waiter(const select_waiter& rhs);
+                select_waiter& operator=(const select_waiter& rhs);
+
+                std::mutex __mutex;
+                std::condition_variable __condition;
+                bool __signaled;
+        };
+
+        /** \brief List of select_waiters registered at one channel. Synchronization is up to the owning channel.
+         */
+        class select_waiter_list
+        {
+            public:
+                void attach(select_waiter* waiter)
+                {
+                    this->__waiters.push_back(waiter);
+                }
+
+                void detach(select_waiter* waiter)
+                {
+                    this->__waiters.erase(std::remove(this->__waiters.begin(), this->__waiters.end(), waiter), this->__waiters.end());
+                }
+
+                bool empty() const
+                {
+                    return this->__waiters.empty();
+                }
+
+                void notify_all()
+                {
+                    for (auto waiter : this->__waiters)
+                    {
+                        waiter->notify();
+                    }
+                }
+
+            private:
+                std::vector<select_waiter*> __waiters;
+        };
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_SELECT_WAITER_HPP__
@@ -0,0 +1,202 @@
+#ifndef __CONCURRENT_INTERNAL_STRAND_HPP__
+#define __CONCURRENT_INTERNAL_STRAND_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "concurrent/executor.hpp"
+#include "concurrent/internal/batch_counter.hpp"
+#include "concurrent/internal/block_pool.hpp"
+#include "concurrent/storage/priority_lanes.hpp"
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Serial task queue on top of an executor. Tasks posted to a strand are executed one after another, in the order
+         *         they were posted, but not necessarily on the same thread. The strand is only scheduled on the executor while
+         *         it has pending tasks, thus an idle strand costs nothing but its memory.
+         *         Every turn on the executor takes all pending tasks, up to the maximum batch size, in one lock acquisition and
+         *         runs them back to back. Afterwards, the strand is rescheduled if there is more to do, so that a busy strand
+         *         cannot starve the others on the same executor.
+         *         Pending tasks are kept in two lanes (see concurrent::priority_lanes): urgent ones are taken before bulk ones.
+         *         Tasks posted as shared (read-only) are the exception to the one-after-another rule: consecutive shared tasks of
+         *         a turn are spread over the executor's workers and run concurrently. The task after them only starts once all
+         *         of them are completed, so they stay ordered relative to the exclusive ones.
+         *
+         *  \note A strand always has to be owned by a std::shared_ptr, since a scheduled strand keeps itself alive.
+         */
+        class strand : public std::enable_shared_from_this<strand>
+        {
+            public:
+                typedef executor::task_type task_type;
+
+                static const std::size_t default_max_batch_size = 64;
+
+                explicit strand(executor& ex) : __executor(ex), __scheduled(false), __maxBatchSize(default_max_batch_size), __position(0), __pendingGroups(0) {}
+
+                /** \brief Enqueues a task and schedules the strand if it is idle.
+                 *
+                 * \param task task_type Task to execute.
+                 * \param lane priority Lane to queue the task in.
+                 * \param shared bool Whether the task may run concurrently with neighbouring shared tasks.
+                 */
+                void post(task_type task, priority lane = priority::bulk, bool shared = false)
+                {
+                    bool schedule = false;
+                    {
+                        std::lock_guard<std::mutex> lock(this->__lock);
+                        this->__tasks.emplace(lane, std::move(task), shared);
+                        schedule = !this->__scheduled;
+                        this->__scheduled = true;
+                    }
+                    if (schedule)
+                    {
+                        this->__schedule();
+                    }
+                }
+
+                executor& get_executor() const
+                {
+                    return this->__executor;
+                }
+
+                /** \brief Sets the maximum number of tasks executed per turn; 0 is treated as 1.
+                 */
+                void set_max_batch_size(std::size_t maxBatchSize)
+                {
+                    this->__maxBatchSize.store(maxBatchSize > 0 ? maxBatchSize : 1, std::memory_order_relaxed);
+                }
+
+                std::size_t max_batch_size() const
+                {
+                    return this->__maxBatchSize.load(std::memory_order_relaxed);
+                }
+
+                batch_statistics get_batch_statistics() const
+                {
+                    return this->__batches.snapshot();
+                }
+
+            private:
+                // Prohibitions
+                strand(const strand& rhs);
+                strand& operator=(const strand& rhs);
+
+                struct entry
+                {
+                    entry(task_type&& t, bool s) : task(std::move(t)), shared(s) {}
+
+                    task_type task;
+                    bool shared;
+                };
+
+                executor& __executor;
+                std::mutex __lock;
+                priority_lanes<entry, std::deque<entry, pool_allocator<entry>>> __tasks;
+                bool __scheduled;                       /**< Whether the strand is queued on or running in the executor */
+                std::atomic<std::size_t> __maxBatchSize;
+                std::vector<entry> __batch;             /**< Tasks of the current turn; only touched by the thread running it */
+                std::size_t __position;                 /**< Next task of the current turn to run */
+                std::atomic<std::size_t> __pendingGroups; /**< Groups of shared tasks of the current turn that are still running */
+                batch_counter __batches;
+
+                void __schedule()
+                {
+                    std::shared_ptr<strand> self = this->shared_from_this();
+                    this->__executor.submit([self]() -> void { self->__run(); });
+                }
+
+                /** \brief Executes pending tasks. Only one thread at a time runs this, as it is only submitted by the one
+                 *         that flipped __scheduled to "true".
+                 */
+                void __run()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(this->__lock);
+                        std::size_t batchSize = std::min(this->__tasks.size(), this->__maxBatchSize.load(std::memory_order_relaxed));
+                        for (std::size_t i = 0; i < batchSize; ++i)
+                        {
+                            this->__batch.push_back(std::move(this->__tasks.front()));
+                            this->__tasks.pop();
+                        }
+                    }
+                    this->__batches.record(this->__batch.size());
+                    this->__position = 0;
+                    this->__continue();
+                }
+
+                /** \brief Runs the tasks of the current turn from __position on, and finishes the turn. If it hands a run of shared
+                 *         tasks over to other workers, it returns right away instead; the last of them to finish calls it again.
+                 */
+                void __continue()
+                {
+                    std::size_t batchSize = this->__batch.size();
+                    while (this->__position < batchSize)
+                    {
+                        std::size_t end = this->__position;
+                        while (end < batchSize && this->__batch[end].shared)
+                        {
+                            ++end;
+                        }
+                        if (end - this->__position > 1 && this->__executor.size() > 1)
+                        {
+                            this->__spread(end);
+                            return;
+                        }
+                        this->__batch[this->__position++].task();
+                    }
+                    this->__batch.clear();
+                    {
+                        std::lock_guard<std::mutex> lock(this->__lock);
+                        if (this->__tasks.empty())
+                        {
+                            this->__scheduled = false;
+                            return;
+                        }
+                    }
+                    this->__schedule();
+                }
+
+                /** \brief Splits the shared tasks from __position to end into one group per worker, submits all but the first
+                 *         group and runs that one itself.
+                 */
+                void __spread(std::size_t end)
+                {
+                    std::size_t begin = this->__position;
+                    std::size_t count = end - begin;
+                    std::size_t numGroups = std::min(count, this->__executor.size());
+                    this->__position = end;
+                    this->__pendingGroups.store(numGroups, std::memory_order_relaxed); // Published by the executor's lock on submit
+                    std::shared_ptr<strand> self = this->shared_from_this();
+                    for (std::size_t group = 1; group < numGroups; ++group)
+                    {
+                        std::size_t groupBegin = begin + count * group / numGroups;
+                        std::size_t groupEnd = begin + count * (group + 1) / numGroups;
+                        this->__executor.submit([self, groupBegin, groupEnd]() -> void { self->__run_shared(groupBegin, groupEnd); });
+                    }
+                    this->__run_shared(begin, begin + count / numGroups);
+                }
+
+                void __run_shared(std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        this->__batch[i].task();
+                    }
+                    if (this->__pendingGroups.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        this->__continue();
+                    }
+                }
+        };
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_STRAND_HPP__
@@ -0,0 +1,310 @@
+#ifndef __CONCURRENT_INTERNAL_TASK_MONITOR_HPP__
+#define __CONCURRENT_INTERNAL_TASK_MONITOR_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifndef CONCURRENT_INSTRUMENTATION_SAMPLING
+#define CONCURRENT_INSTRUMENTATION_SAMPLING 16   /**< Every how many functors are timed; reading the clock costs more than many a functor */
+#endif
+
+namespace concurrent
+{
+    /** \brief Histogram of durations in buckets of powers of two: bucket i counts durations of [2^(i-1), 2^i) nanoseconds,
+     *         bucket 0 those below 1 ns, and the last one everything from about 1 s on.
+     */
+    struct latency_histogram
+    {
+        static const std::size_t num_buckets = 32;
+
+        std::array<std::uint64_t, num_buckets> counts;
+
+        std::uint64_t total() const
+        {
+            std::uint64_t sum = 0;
+            for (std::uint64_t count : this->counts)
+            {
+                sum += count;
+            }
+            return sum;
+        }
+
+        /** \brief Upper bound of the bucket the given fraction of all durations falls into, e.g. 0.99 for the 99th percentile.
+         *
+         * \param fraction double Fraction in [0, 1].
+         * \return std::uint64_t Nanoseconds, or 0 if there are no durations.
+         */
+        std::uint64_t percentile_ns(double fraction) const
+        {
+            std::uint64_t sum = this->total();
+            if (sum == 0)
+            {
+                return 0;
+            }
+            std::uint64_t rank = static_cast<std::uint64_t>(fraction * (sum - 1)) + 1;
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < num_buckets; ++i)
+            {
+                seen += this->counts[i];
+                if (seen >= rank)
+                {
+                    return upper_bound_ns(i);
+                }
+            }
+            return upper_bound_ns(num_buckets - 1);
+        }
+
+        static std::uint64_t upper_bound_ns(std::size_t bucket)
+        {
+            return std::uint64_t(1) << bucket;
+        }
+    };
+
+    /** \brief Snapshot of the instrumentation of an async_object. The counters only ever grow, thus two snapshots taken at
+     *         different times give rates, e.g. tasks_per_second().
+     */
+    struct task_statistics
+    {
+        bool enabled;                                       /**< Whether instrumentation was compiled in; all other members are zero if not */
+        std::chrono::steady_clock::time_point taken_at;
+        std::uint64_t enqueued;                             /**< Functors sent so far */
+        std::uint64_t started;                              /**< Functors whose execution started so far */
+        std::uint64_t completed;                            /**< Functors executed so far */
+        latency_histogram sojourn;                          /**< Time from sending a functor to the start of its execution, for every CONCURRENT_INSTRUMENTATION_SAMPLING-th functor */
+        latency_histogram execution;                        /**< Time the functors took to execute, for the same ones */
+
+        /** \brief Number of functors that were sent but not started yet.
+         */
+        std::uint64_t queue_depth() const
+        {
+            return this->enqueued > this->started ? this->enqueued - this->started : 0;
+        }
+
+        /** \brief Rate of completed functors between an earlier snapshot and this one.
+         */
+        double tasks_per_second(const task_statistics& earlier) const
+        {
+            std::chrono::duration<double> elapsed = this->taken_at - earlier.taken_at;
+            return elapsed.count() > 0 ? (this->completed - earlier.completed) / elapsed.count() : 0.0;
+        }
+
+        /** \brief Hands every value over to a metrics system, as (name, value) pairs. Histograms are exported as cumulative
+         *         counts per bucket upper bound, e.g. "<prefix>_sojourn_ns_le_1024".
+         *
+         * \param sink Sink& Callable taking (const std::string&, std::uint64_t).
+         * \param prefix const std::string& Prefix for all names, e.g. the name of the object.
+         */
+        template<typename Sink>
+        void export_to(Sink& sink, const std::string& prefix) const
+        {
+            sink(prefix + "_enqueued", this->enqueued);
+            sink(prefix + "_started", this->started);
+            sink(prefix + "_completed", this->completed);
+            sink(prefix + "_queue_depth", this->queue_depth());
+            __export_histogram(sink, prefix + "_sojourn_ns", this->sojourn);
+            __export_histogram(sink, prefix + "_execution_ns", this->execution);
+        }
+
+        template<typename Sink>
+        static void __export_histogram(Sink& sink, const std::string& name, const latency_histogram& histogram)
+        {
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < latency_histogram::num_buckets; ++i)
+            {
+                cumulative += histogram.counts[i];
+                sink(name + "_le_" + std::to_string(latency_histogram::upper_bound_ns(i)), cumulative);
+            }
+        }
+    };
+
+    namespace internal
+    {
+#ifdef CONCURRENT_INSTRUMENTATION
+        /** \brief Counts the functors of an async_object and measures how long they wait and run. Functors are counted by
+         *         any thread that sends them, and measured by the ones that execute them - possibly several at once, since
+         *         read-only functors may run concurrently. Only every CONCURRENT_INSTRUMENTATION_SAMPLING-th functor is timed, since each measurement takes three
+         *         clock readings; the counters are exact.
+         */
+        class task_monitor
+        {
+            public:
+                static const bool enabled = true;
+                static const std::uint64_t sampling = CONCURRENT_INSTRUMENTATION_SAMPLING > 0 ? CONCURRENT_INSTRUMENTATION_SAMPLING : 1;
+
+                /** \brief Functor wrapper that counts the execution and, if the functor was sampled, takes the time from sending to
+                 *         execution and of the execution itself. It wraps the sent functor itself, not the task around it, so
+                 *         the execution is recorded as soon as the functor returns (or throws) - before the task fulfils a
+                 *         promise, which may let the owner of the monitor be destroyed.
+                 */
+                template<typename F>
+                struct monitored
+                {
+                    F f;
+                    task_monitor* monitor;
+                    std::chrono::steady_clock::time_point enqueuedAt;      /**< Epoch if the functor is not sampled */
+
+                    template<typename... Args>
+                    auto operator()(Args&&... args) -> decltype(this->f(std::forward<Args>(args)...))
+                    {
+                        completion done(this->monitor, this->enqueuedAt);
+                        return this->f(std::forward<Args>(args)...);
+                    }
+                };
+
+                task_monitor() : __enqueued(0), __started(0), __completed(0)
+                {
+                    __reset(this->__sojourn);
+                    __reset(this->__execution);
+                }
+
+                template<typename F>
+                monitored<typename std::decay<F>::type> wrap(F&& f)
+                {
+                    bool sampled = this->__enqueued.fetch_add(1, std::memory_order_relaxed) % sampling == 0;
+                    return monitored<typename std::decay<F>::type>{ std::forward<F>(f), this, sampled ? std::chrono::steady_clock::now()
+                                                                                                      : std::chrono::steady_clock::time_point() };
+                }
+
+                task_statistics snapshot() const
+                {
+                    task_statistics result;
+                    result.enabled = true;
+                    result.taken_at = std::chrono::steady_clock::now();
+                    result.completed = this->__completed.load(std::memory_order_relaxed);
+                    result.started = this->__started.load(std::memory_order_relaxed);
+                    result.enqueued = this->__enqueued.load(std::memory_order_relaxed);
+                    for (std::size_t i = 0; i < latency_histogram::num_buckets; ++i)
+                    {
+                        result.sojourn.counts[i] = this->__sojourn[i].load(std::memory_order_relaxed);
+                        result.execution.counts[i] = this->__execution[i].load(std::memory_order_relaxed);
+                    }
+                    return result;
+                }
+
+            private:
+                // Prohibitions
+                task_monitor(const task_monitor& rhs);
+                task_monitor& operator=(const task_monitor& rhs);
+
+                /** \brief Records the start of an execution on construction and its completion on destruction.
+                 */
+                class completion
+                {
+                    public:
+                        completion(task_monitor* monitor, std::chrono::steady_clock::time_point enqueuedAt)
+                            : __monitor(monitor), __sampled(enqueuedAt != std::chrono::steady_clock::time_point())
+                        {
+                            if (!this->__sampled)
+                            {
+                                __increment(this->__monitor->__started);
+                                return;
+                            }
+                            this->__startedAt = std::chrono::steady_clock::now();
+                            this->__monitor->__on_start(this->__startedAt - enqueuedAt);
+                        }
+
+                        ~completion()
+                        {
+                            if (!this->__sampled)
+                            {
+                                __increment(this->__monitor->__completed);
+                                return;
+                            }
+                            this->__monitor->__on_complete(std::chrono::steady_clock::now() - this->__startedAt);
+                        }
+
+                    private:
+                        // Prohibitions
+                        completion(const completion& rhs);
+                        completion& operator=(const completion& rhs);
+
+                        task_monitor* __monitor;
+                        bool __sampled;
+                        std::chrono::steady_clock::time_point __startedAt;
+                };
+
+                typedef std::array<std::atomic<std::uint64_t>, latency_histogram::num_buckets> buckets;
+
+                std::atomic<std::uint64_t> __enqueued;
+                std::atomic<std::uint64_t> __started;
+                std::atomic<std::uint64_t> __completed;
+                buckets __sojourn;
+                buckets __execution;
+
+                void __on_start(std::chrono::steady_clock::duration waited)
+                {
+                    __increment(this->__started);
+                    __increment(this->__sojourn[__bucket(waited)]);
+                }
+
+                void __on_complete(std::chrono::steady_clock::duration took)
+                {
+                    __increment(this->__execution[__bucket(took)]);
+                    __increment(this->__completed);
+                }
+
+                static std::size_t __bucket(std::chrono::steady_clock::duration d)
+                {
+                    std::int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+                    std::size_t bucket = 0;
+                    while (ns > 0 && bucket + 1 < latency_histogram::num_buckets)
+                    {
+                        ns >>= 1;
+                        ++bucket;
+                    }
+                    return bucket;
+                }
+
+                static void __reset(buckets& histogram)
+                {
+                    for (auto& bucket : histogram)
+                    {
+                        bucket.store(0, std::memory_order_relaxed);
+                    }
+                }
+
+                static void __increment(std::atomic<std::uint64_t>& counter)
+                {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                }
+        };
+#else
+        /** \brief Stand-in for the task_monitor if CONCURRENT_INSTRUMENTATION is not defined: it passes functors through
+         *         untouched and reports empty statistics, so instrumentation costs nothing unless it is enabled.
+         */
+        class task_monitor
+        {
+            public:
+                static const bool enabled = false;
+
+                task_monitor() {}
+
+                template<typename F>
+                F&& wrap(F&& f)
+                {
+                    return std::forward<F>(f);
+                }
+
+                task_statistics snapshot() const
+                {
+                    task_statistics result = task_statistics();
+                    result.taken_at = std::chrono::steady_clock::now();
+                    return result;
+                }
+
+            private:
+                // Prohibitions
+                task_monitor(const task_monitor& rhs);
+                task_monitor& operator=(const task_monitor& rhs);
+        };
+#endif
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_TASK_MONITOR_HPP__
@@ -0,0 +1,139 @@
+#ifndef __CONCURRENT_INTERNAL_WAITER_HPP__
+#define __CONCURRENT_INTERNAL_WAITER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "concurrent/wait_strategy.hpp"
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Parking spot for threads that have to wait for a non-blocking operation to succeed, e.g. a pop on an empty
+         *         lock-free ring. Waiting threads retry the operation according to the configured wait_strategy and park on
+         *         a condition variable afterwards. The mutex is only touched by threads that are about to park and by notifiers that actually
+         *         have someone to wake up, so the fast path of both sides stays lock-free.
+         */
+        class waiter
+        {
+            public:
+                waiter() : __strategy(wait_strategy::balanced()), __waiting(0) {}
+
+                void set_strategy(const wait_strategy& strategy)
+                {
+                    this->__strategy = strategy;
+                }
+
+                const wait_strategy& strategy() const
+                {
+                    return this->__strategy;
+                }
+
+                /** \brief Blocks until tryOp() returns true.
+                 *
+                 * \param tryOp TryOp Non-blocking operation that returns "true" on success. It may be called several times.
+                 */
+                template<typename TryOp>
+                void wait(TryOp tryOp)
+                {
+                    if (this->__strategy.spin(tryOp))
+                    {
+                        return;
+                    }
+                    std::unique_lock<std::mutex> lock(this->__parkMutex);
+                    this->__waiting.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in notify_*(): either we see the new state, or the notifier sees us.
+                    try
+                    {
+                        while (!tryOp())
+                        {
+                            this->__parkCondition.wait(lock);
+                        }
+                    }
+                    catch (...) // tryOp() may throw, e.g. if a message could not be constructed.
+                    {
+                        this->__waiting.fetch_sub(1);
+                        throw;
+                    }
+                    this->__waiting.fetch_sub(1);
+                }
+
+                /** \brief Blocks until tryOp() returns true or the deadline passed.
+                 *
+                 * \param tryOp TryOp Non-blocking operation that returns "true" on success. It may be called several times.
+                 * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+                 * \return bool "true" if tryOp() succeeded, "false" on timeout.
+                 */
+                template<typename TryOp, typename Clock, typename Duration>
+                bool wait_until(TryOp tryOp, const std::chrono::time_point<Clock, Duration>& deadline)
+                {
+                    if (this->__strategy.spin(tryOp))
+                    {
+                        return true;
+                    }
+                    std::unique_lock<std::mutex> lock(this->__parkMutex);
+                    this->__waiting.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst); // See wait().
+                    bool succeeded = false;
+                    try
+                    {
+                        succeeded = tryOp();
+                        while (!succeeded && this->__parkCondition.wait_until(lock, deadline) != std::cv_status::timeout)
+                        {
+                            succeeded = tryOp();
+                        }
+                        if (!succeeded)
+                        {
+                            succeeded = tryOp(); // Last chance, the state might have changed right at the deadline.
+                        }
+                    }
+                    catch (...) // See wait().
+                    {
+                        this->__waiting.fetch_sub(1);
+                        throw;
+                    }
+                    this->__waiting.fetch_sub(1);
+                    return succeeded;
+                }
+
+                /** \brief Wakes up one parked thread, if there is any. Has to be called after the state change a waiter might wait for.
+                 */
+                void notify_one()
+                {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (this->__waiting.load(std::memory_order_relaxed) > 0)
+                    {
+                        std::lock_guard<std::mutex> lock(this->__parkMutex); // Waiters check and park while holding the lock, thus no wakeup can get lost.
+                        this->__parkCondition.notify_one();
+                    }
+                }
+
+                /** \brief Wakes up all parked threads, if there are any.
+                 */
+                void notify_all()
+                {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (this->__waiting.load(std::memory_order_relaxed) > 0)
+                    {
+                        std::lock_guard<std::mutex> lock(this->__parkMutex);
+                        this->__parkCondition.notify_all();
+                    }
+                }
+
+            private:
+                // Prohibitions
+                waiter(const waiter& rhs);
+                waiter& operator=(const waiter& rhs);
+
+                wait_strategy __strategy;
+                std::atomic<unsigned> __waiting;                /**< Number of parked (or about to be parked) threads */
+                std::mutex __parkMutex;
+                std::condition_variable __parkCondition;
+        };
+    }
+}
+
+#endif // !__CONCURRENT_INTERNAL_WAITER_HPP__
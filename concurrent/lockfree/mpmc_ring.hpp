@@ -0,0 +1,225 @@
+#ifndef __CONCURRENT_LOCKFREE_MPMC_RING_HPP__
+#define __CONCURRENT_LOCKFREE_MPMC_RING_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent/internal/cache_line.hpp"
+
+namespace concurrent
+{
+    /** \brief Bounded lock-free multi-producer/multi-consumer ring, based on Dmitry Vyukov's bounded MPMC queue.
+     *         http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+     *         Every slot carries a sequence number that tells producers and consumers whether it is free for the current
+     *         lap or holds a message, so each side only has to claim a position with a single CAS and never waits for the other.
+     *         The ring only offers non-blocking operations; using it as Storage parameter of concurrent::queue or concurrent::channel
+     *         selects their lock-free implementation, which adds blocking on top of it.
+     *  \param T Type of the elements to store. Moving it must not throw: once a position is claimed, the slot has to be
+     *         handed on, or the ring would wedge. Its other constructors may throw; see try_emplace().
+     *  \param Alloc Allocator used for the slot buffer (rebound to the internal slot type).
+     */
+    template<typename T, typename Alloc = std::allocator<T>>
+    class mpmc_ring
+    {
+        static_assert( std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                       "Moving T must not throw, since a claimed slot could not be handed on otherwise!" );
+
+        struct cell
+        {
+            std::atomic<std::size_t> sequence;
+            bool filled;                        /**< "false" if constructing the element threw; consumers skip such a slot */
+            typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type data;
+        };
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<cell> cell_allocator;
+        typedef std::allocator_traits<cell_allocator> cell_traits;
+
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+
+            static const size_type default_capacity = 1024; /**< Capacity used if none was given explicitly */
+
+            /** \brief C'tor. Allocates all slots up-front.
+             *
+             * \param capacity size_type Minimum number of elements that may be stored at the same time. Gets rounded up to the next power of two.
+             * \param alloc const Alloc& Allocator instance to use.
+             */
+            explicit mpmc_ring(size_type capacity = default_capacity, const Alloc& alloc = Alloc())
+                : __alloc(alloc), __cells(nullptr), __mask(__round_up(capacity) - 1), __enqueuePos(0), __dequeuePos(0)
+            {
+                this->__cells = cell_traits::allocate(this->__alloc, this->__mask + 1);
+                for (size_type i = 0; i <= this->__mask; ++i)
+                {
+                    new (std::addressof(this->__cells[i].sequence)) std::atomic<size_type>(i);
+                }
+            }
+
+            ~mpmc_ring()
+            {
+                size_type tail = this->__enqueuePos.load(std::memory_order_relaxed);
+                for (size_type pos = this->__dequeuePos.load(std::memory_order_relaxed); pos != tail; ++pos)
+                {
+                    cell& c = this->__cells[pos & this->__mask];
+                    if (c.filled)
+                    {
+                        reinterpret_cast<T*>(std::addressof(c.data))->~T();
+                    }
+                }
+                cell_traits::deallocate(this->__alloc, this->__cells, this->__mask + 1);
+            }
+
+            /** \brief Adds an element if a slot is free.
+             *
+             * \param value U&& Element to add; it is only moved from if the function succeeds.
+             * \return bool "true" if the element was added, "false" if the ring is full.
+             */
+            template<typename U>
+            bool try_push(U&& value)
+            {
+                return this->try_emplace(std::forward<U>(value));
+            }
+
+            /** \brief Constructs an element in place if a slot is free.
+             *
+             * \param args Args&&... Arguments that are forwarded to the constructor of T; they are only used if the function succeeds.
+             * \return bool "true" if the element was added, "false" if the ring is full.
+             * \note The slot is claimed before the element is constructed in it. If the constructor throws, the slot is handed
+             *       on empty - consumers skip it - and the exception is passed on. Until a consumer passed it, that slot takes up
+             *       room and is counted by size().
+             */
+            template<typename... Args>
+            bool try_emplace(Args&&... args)
+            {
+                size_type pos;
+                cell* c = this->__claim(this->__enqueuePos, 0, pos);
+                if (c == nullptr)
+                {
+                    return false;
+                }
+                try
+                {
+                    new (std::addressof(c->data)) T(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    c->filled = false;
+                    c->sequence.store(pos + 1, std::memory_order_release); // Publish the empty slot, so the ring goes on.
+                    throw;
+                }
+                c->filled = true;
+                c->sequence.store(pos + 1, std::memory_order_release); // Publish to consumers.
+                return true;
+            }
+
+            /** \brief Takes the oldest element if there is one.
+             *
+             * \param destination T& Variable to move the element to.
+             * \return bool "true" if an element was taken, "false" if the ring is empty.
+             */
+            bool try_pop(T& destination)
+            {
+                size_type pos;
+                cell* c = this->__claim(this->__dequeuePos, 1, pos);
+                while (c != nullptr && !c->filled)
+                {
+                    c->sequence.store(pos + this->__mask + 1, std::memory_order_release); // Nothing to take; hand it on, too.
+                    c = this->__claim(this->__dequeuePos, 1, pos);
+                }
+                if (c == nullptr)
+                {
+                    return false;
+                }
+                T* elem = reinterpret_cast<T*>(std::addressof(c->data));
+                destination = std::move(*elem);
+                elem->~T();
+                c->sequence.store(pos + this->__mask + 1, std::memory_order_release); // Hand the slot over to the producers of the next lap.
+                return true;
+            }
+
+            /** \brief Snapshot of the number of stored elements. Might already be outdated when it is returned.
+             */
+            size_type size() const
+            {
+                size_type tail = this->__enqueuePos.load(std::memory_order_acquire);
+                size_type head = this->__dequeuePos.load(std::memory_order_acquire);
+                return tail > head ? tail - head : 0;
+            }
+
+            bool empty() const
+            {
+                return this->size() == 0;
+            }
+
+            size_type capacity() const
+            {
+                return this->__mask + 1;
+            }
+
+        private:
+            // Prohibitions
+            mpmc_ring(const mpmc_ring& rhs);                /**< Slots are owned exclusively */
+            mpmc_ring& operator=(const mpmc_ring& rhs);     /**< Slots are owned exclusively */
+
+            cell_allocator __alloc;
+            cell* __cells;
+            size_type __mask;
+            char __pad0[cache_line_size];                   /**< Keep producers' and consumers' positions on separate cache lines */
+            std::atomic<size_type> __enqueuePos;
+            char __pad1[cache_line_size];
+            std::atomic<size_type> __dequeuePos;
+            char __pad2[cache_line_size];
+
+            /** \brief Claims the slot at the given position once its sequence number shows that it is ready for this side.
+             *
+             * \param position std::atomic<size_type>& Position counter of the claiming side.
+             * \param offset size_type 0 if a producer claims (slot must be free), 1 if a consumer claims (slot must be filled).
+             * \param pos size_type& Receives the claimed position.
+             * \return cell* The claimed slot, or nullptr if the ring is full (producer) or empty (consumer).
+             */
+            cell* __claim(std::atomic<size_type>& position, size_type offset, size_type& pos)
+            {
+                pos = position.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    cell* c = this->__cells + (pos & this->__mask);
+                    size_type seq = c->sequence.load(std::memory_order_acquire);
+                    std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + offset);
+                    if (diff == 0)
+                    {
+                        if (position.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            return c;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return nullptr;
+                    }
+                    else
+                    {
+                        pos = position.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            static size_type __round_up(size_type capacity)
+            {
+                size_type result = 2;
+                while (result < capacity)
+                {
+                    result <<= 1;
+                }
+                return result;
+            }
+    };
+
+    template<typename T, typename Alloc>
+    const typename mpmc_ring<T, Alloc>::size_type mpmc_ring<T, Alloc>::default_capacity;
+}
+
+#endif // !__CONCURRENT_LOCKFREE_MPMC_RING_HPP__
@@ -0,0 +1,162 @@
+#ifndef __CONCURRENT_LOCKFREE_SPSC_RING_HPP__
+#define __CONCURRENT_LOCKFREE_SPSC_RING_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "concurrent/internal/cache_line.hpp"
+
+namespace concurrent
+{
+    /** \brief Bounded wait-free single-producer/single-consumer ring.
+     *         Each side owns one position counter and keeps a private copy of the other side's counter, which is only
+     *         refreshed if the ring looks full (producer) or empty (consumer). Thus, in the common case each operation touches
+     *         nothing but its own cache line and the slot itself. Both sides are separated by padding to avoid false sharing.
+     *         Using it as Storage parameter of concurrent::channel selects the SPSC channel.
+     *  \param T Type of the elements to store.
+     *  \param Alloc Allocator used for the slot buffer.
+     *  \note Only one thread may push and only one thread may pop at the same time.
+     */
+    template<typename T, typename Alloc = std::allocator<T>>
+    class spsc_ring
+    {
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+
+            static const size_type default_capacity = 1024; /**< Capacity used if none was given explicitly */
+
+            /** \brief C'tor. Allocates all slots up-front.
+             *
+             * \param capacity size_type Minimum number of elements that may be stored at the same time. Gets rounded up to the next power of two.
+             * \param alloc const Alloc& Allocator instance to use.
+             */
+            explicit spsc_ring(size_type capacity = default_capacity, const Alloc& alloc = Alloc())
+                : __alloc(alloc), __slots(nullptr), __mask(__round_up(capacity) - 1), __tail(0), __cachedHead(0), __head(0), __cachedTail(0)
+            {
+                this->__slots = alloc_traits::allocate(this->__alloc, this->__mask + 1);
+            }
+
+            ~spsc_ring()
+            {
+                size_type tail = this->__tail.load(std::memory_order_relaxed);
+                for (size_type pos = this->__head.load(std::memory_order_relaxed); pos != tail; ++pos)
+                {
+                    alloc_traits::destroy(this->__alloc, this->__slots + (pos & this->__mask));
+                }
+                alloc_traits::deallocate(this->__alloc, this->__slots, this->__mask + 1);
+            }
+
+            /** \brief Adds an element if a slot is free. May only be called by the producer thread.
+             *
+             * \param value U&& Element to add; it is only moved from if the function succeeds.
+             * \return bool "true" if the element was added, "false" if the ring is full.
+             */
+            template<typename U>
+            bool try_push(U&& value)
+            {
+                return this->try_emplace(std::forward<U>(value));
+            }
+
+            /** \brief Constructs an element in place if a slot is free. May only be called by the producer thread.
+             *
+             * \param args Args&&... Arguments that are forwarded to the constructor of T; they are only used if the function succeeds.
+             * \return bool "true" if the element was added, "false" if the ring is full.
+             */
+            template<typename... Args>
+            bool try_emplace(Args&&... args)
+            {
+                size_type tail = this->__tail.load(std::memory_order_relaxed);
+                if (tail - this->__cachedHead > this->__mask)
+                {
+                    this->__cachedHead = this->__head.load(std::memory_order_acquire);
+                    if (tail - this->__cachedHead > this->__mask)
+                    {
+                        return false;
+                    }
+                }
+                alloc_traits::construct(this->__alloc, this->__slots + (tail & this->__mask), std::forward<Args>(args)...);
+                this->__tail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            /** \brief Takes the oldest element if there is one. May only be called by the consumer thread.
+             *
+             * \param destination T& Variable to move the element to.
+             * \return bool "true" if an element was taken, "false" if the ring is empty.
+             */
+            bool try_pop(T& destination)
+            {
+                size_type head = this->__head.load(std::memory_order_relaxed);
+                if (head == this->__cachedTail)
+                {
+                    this->__cachedTail = this->__tail.load(std::memory_order_acquire);
+                    if (head == this->__cachedTail)
+                    {
+                        return false;
+                    }
+                }
+                T* elem = this->__slots + (head & this->__mask);
+                destination = std::move(*elem);
+                alloc_traits::destroy(this->__alloc, elem);
+                this->__head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            /** \brief Snapshot of the number of stored elements. Might already be outdated when it is returned.
+             */
+            size_type size() const
+            {
+                size_type head = this->__head.load(std::memory_order_acquire);
+                return this->__tail.load(std::memory_order_acquire) - head;
+            }
+
+            bool empty() const
+            {
+                return this->size() == 0;
+            }
+
+            size_type capacity() const
+            {
+                return this->__mask + 1;
+            }
+
+        private:
+            // Prohibitions
+            spsc_ring(const spsc_ring& rhs);                /**< Slots are owned exclusively */
+            spsc_ring& operator=(const spsc_ring& rhs);     /**< Slots are owned exclusively */
+
+            Alloc __alloc;
+            T* __slots;
+            size_type __mask;
+            char __pad0[cache_line_size];
+            // Producer side
+            std::atomic<size_type> __tail;                  /**< Next position to write to */
+            size_type __cachedHead;                         /**< Producer's copy of __head */
+            char __pad1[cache_line_size];
+            // Consumer side
+            std::atomic<size_type> __head;                  /**< Next position to read from */
+            size_type __cachedTail;                         /**< Consumer's copy of __tail */
+            char __pad2[cache_line_size];
+
+            static size_type __round_up(size_type capacity)
+            {
+                size_type result = 2;
+                while (result < capacity)
+                {
+                    result <<= 1;
+                }
+                return result;
+            }
+    };
+
+    template<typename T, typename Alloc>
+    const typename spsc_ring<T, Alloc>::size_type spsc_ring<T, Alloc>::default_capacity;
+}
+
+#endif // !__CONCURRENT_LOCKFREE_SPSC_RING_HPP__
@@ -1,19 +1,30 @@
 #ifndef __CONCURRENT_QUEUE_HPP__
 #define __CONCURRENT_QUEUE_HPP__
 
-#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <type_traits>
 
+#include "concurrent/internal/parking_condition.hpp"
+#include "concurrent/internal/waiter.hpp"
+#include "concurrent/lockfree/mpmc_ring.hpp"
+#include "concurrent/wait_strategy.hpp"
+#include "util/detect.hpp"
+#include "util/member_clear.hpp"
+#include "util/member_full.hpp"
+
 namespace concurrent
 {
     /** \brief This is the basic concurrent queue class. It provides a stream-like
      *         message add/remove. Most of these functions are borrowed from a former project of mine,
      *         https://github.com/DorianGrey/Channel/ , which was a purpose to build golang-channels 
      *         in C++.
-     *  \param MsgType Type of the messages that are exchanged between the communications partners.
+     *  \param MsgType Type of the messages that are exchanged between the communications partners. Has to be
+     *         move-constructible; move-only types like std::unique_ptr are fine, since messages are moved on every hop.
      *  \param Storage Container class.
      *         Note that any container you use has to implement either the queue policy (here: push(T),
      *         pop(), front(), empty() ) directly or has to adopt the queue internals, like shown in
@@ -22,16 +33,42 @@ namespace concurrent
      *         I.e., by default, deque and list are implementing this, like
      *         template < class T, class Container = std::deque<T> > class queue
      *         template < class T, class Container = std::list<T> > class queue .
+     *         If the container offers a "bool full() const" member (like concurrent::ring_buffer does), it is considered to be
+     *         bounded: push() blocks until there is room for the message, and try_push() fails instead of blocking.
      *  \param OptArgs Optional arguments that are getting passed to the storage template declaration,
-     *         e.g. for a custom allocator.
+     *         e.g. for a custom allocator. See concurrent/storage/pool_resource.hpp for storage on top of std::pmr.
      */
     template<typename MsgType, template<typename, typename...> class Storage = std::queue, typename... OptArgs>
     class queue
     {
-        static_assert( std::is_copy_constructible<MsgType>::value, "The message type requires to be copy-constructible!" );
+        static_assert( std::is_move_constructible<MsgType>::value, "The message type requires to be move-constructible!" );
+
+        typedef Storage<MsgType, OptArgs...> storage_type;
+        static const bool is_bounded = detect::has_member_full<storage_type>::value;
 
         public:
             queue(){};
+
+            /** \brief C'tor for bounded storage, e.g. concurrent::ring_buffer.
+             *
+             * \param capacity std::size_t Maximum number of messages that may be queued at the same time.
+             */
+            explicit queue(std::size_t capacity) : __storage(capacity) {};
+
+            /** \brief C'tor that hands an allocator over to the storage, e.g. a std::pmr::memory_resource* for pmr::deque_storage.
+             *
+             * \param alloc const Alloc& Allocator (or anything the storage's allocator can be constructed from).
+             */
+            template<typename Alloc>
+            queue(std::allocator_arg_t, const Alloc& alloc) : __storage(alloc) {};
+
+            /** \brief C'tor for bounded storage that hands an allocator over to the storage, e.g. for pmr::ring_buffer.
+             *
+             * \param alloc const Alloc& Allocator (or anything the storage's allocator can be constructed from).
+             * \param capacity std::size_t Maximum number of messages that may be queued at the same time.
+             */
+            template<typename Alloc>
+            queue(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity) : __storage(capacity, alloc) {};
             ~queue(){};
 
             /** \brief Function that adds a message to the queue. Message is taken as reference.
@@ -39,11 +76,12 @@ namespace concurrent
             * \param msg const MsgType Message to be added to the queue.
             * \return *this
             *
-            * \note Function blocks until thread-safe access to the queue is possible.
+            * \note Function blocks until thread-safe access to the queue is possible and, in case of bounded storage, there is room for the message.
             */
             queue& push(const MsgType& msg)
             {
                 std::unique_lock<std::mutex> lock(this->__accessMutex); // Since std::queue is not thread-safe, we need the lock here.
+                this->__wait_not_full(lock);
                 this->__storage.push(msg);
                 this->__waitCondition.notify_one();
                 return *this;
@@ -54,16 +92,173 @@ namespace concurrent
             * \param msg MsgType&& Message to be added to the queue.
             * \return *this
             *
-            * \note Function blocks until thread-safe access to the queue is possible.
+            * \note Function blocks until thread-safe access to the queue is possible and, in case of bounded storage, there is room for the message.
             */
             queue& push(MsgType&& msg)
             {
                 std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__wait_not_full(lock);
+                this->__storage.push(std::move(msg));
+                this->__waitCondition.notify_one();
+                return *this;
+            }
+
+            /** \brief Function that constructs a message in place at the end of the queue.
+            *
+            * \param args Args&&... Arguments that are forwarded to the constructor of MsgType.
+            * \return *this
+            *
+            * \note Requires the storage to offer emplace(), like std::queue and concurrent::ring_buffer do.
+            *       Function blocks like push().
+            */
+            template<typename... Args>
+            queue& emplace(Args&&... args)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__wait_not_full(lock);
+                this->__storage.emplace(std::forward<Args>(args)...);
+                this->__waitCondition.notify_one();
+                return *this;
+            }
+
+            /** \brief Function that adds a message to the queue if there is room for it. Message is taken as reference.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \return bool "true" if the message was added, "false" if the (bounded) storage is full.
+            *
+            * \note Function blocks until thread-safe access to the queue is possible, but never waits for room.
+            */
+            bool try_push(const MsgType& msg)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (this->__full())
+                {
+                    return false;
+                }
+                this->__storage.push(msg);
+                this->__waitCondition.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue if there is room for it. Message is taken as r-value.
+            *
+            * \param msg MsgType&& Message to be added to the queue.
+            * \return bool "true" if the message was added, "false" if the (bounded) storage is full. In the latter case, msg is left untouched.
+            *
+            * \note Function blocks until thread-safe access to the queue is possible, but never waits for room.
+            */
+            bool try_push(MsgType&& msg)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (this->__full())
+                {
+                    return false;
+                }
+                this->__storage.push(std::move(msg));
+                this->__waitCondition.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue, waiting for room at most until the given deadline.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+            * \return bool "true" if the message was added, "false" if the (bounded) storage was still full at the deadline.
+            *
+            * \note Only waiting for room is limited by the deadline, not acquiring the lock. Unbounded storage never times out.
+            */
+            template<typename Clock, typename Duration>
+            bool push_until(const MsgType& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (!this->__wait_not_full_until(lock, deadline))
+                {
+                    return false;
+                }
                 this->__storage.push(msg);
                 this->__waitCondition.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue, waiting for room at most until the given deadline. Message is taken as r-value.
+            *
+            * \return bool "true" if the message was added, "false" on timeout. In the latter case, msg is left untouched.
+            * \see push_until(const MsgType&, const std::chrono::time_point<Clock, Duration>&)
+            */
+            template<typename Clock, typename Duration>
+            bool push_until(MsgType&& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                if (!this->__wait_not_full_until(lock, deadline))
+                {
+                    return false;
+                }
+                this->__storage.push(std::move(msg));
+                this->__waitCondition.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue, waiting for room at most for the given duration.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \param timeout const std::chrono::duration<Rep, Period>& Maximum time to wait.
+            * \return bool "true" if the message was added, "false" on timeout.
+            */
+            template<typename Rep, typename Period>
+            bool push_for(const MsgType& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->push_until(msg, std::chrono::steady_clock::now() + timeout);
+            }
+
+            template<typename Rep, typename Period>
+            bool push_for(MsgType&& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->push_until(std::move(msg), std::chrono::steady_clock::now() + timeout);
+            }
+
+            /** \brief Function that adds a sequence of messages to the queue, acquiring the lock only once and waking up
+            *         waiting consumers only once for the whole batch.
+            *
+            * \param first InputIt Begin of the sequence. Use std::make_move_iterator to move the messages into the queue.
+            * \param last InputIt End of the sequence.
+            * \return *this
+            *
+            * \note Function blocks until thread-safe access to the queue is possible. In case of bounded storage, it waits for room
+            *       whenever the storage gets full in between; the part of the batch that was already added is handed over to the
+            *       consumers before.
+            */
+            template<typename InputIt>
+            queue& push_bulk(InputIt first, InputIt last)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                std::size_t pushed = 0;
+                for (; first != last; ++first)
+                {
+                    if (is_bounded && this->__full())
+                    {
+                        this->__notify_pushed(pushed);
+                        pushed = 0;
+                        this->__wait_not_full(lock);
+                    }
+                    this->__storage.push(*first);
+                    ++pushed;
+                }
+                this->__notify_pushed(pushed);
                 return *this;
             }
 
+            /** \brief Function that adds all messages of a range (anything that supports std::begin/std::end) to the queue.
+            *
+            * \param range const Range& Messages to add.
+            * \return *this
+            * \see push_bulk(InputIt, InputIt)
+            */
+            template<typename Range>
+            queue& push_bulk(const Range& range)
+            {
+                return this->push_bulk(std::begin(range), std::end(range));
+            }
+
             /** \brief Function that takes the next available message from the internal message queue.
              *
              * \param destination MsgType& Variable to write the message to.
@@ -78,16 +273,88 @@ namespace concurrent
                 {
                     return !this->__storage.empty();
                 });
-                auto destination = this->__storage.front();
+                MsgType destination = std::move(this->__storage.front());
                 this->__storage.pop();
+                this->__notify_not_full();
                 return destination;
             }
 
+            /** \brief Function that takes the next available message, waiting for one at most until the given deadline.
+             *
+             * \param destination MsgType& Variable to write the message to.
+             * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+             * \return bool "true" if a message was taken, "false" if the queue was still empty at the deadline.
+             *
+             * \note Only waiting for a message is limited by the deadline, not acquiring the lock.
+             */
+            template<typename Clock, typename Duration>
+            bool pop_until(MsgType& destination, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__waitCondition.wait_until(lock, deadline, [this]()->bool
+                {
+                    return !this->__storage.empty();
+                });
+                return this->__take(&destination, 1) == 1;
+            }
+
+            /** \brief Function that takes the next available message, waiting for one at most for the given duration.
+             *
+             * \param destination MsgType& Variable to write the message to.
+             * \param timeout const std::chrono::duration<Rep, Period>& Maximum time to wait.
+             * \return bool "true" if a message was taken, "false" on timeout.
+             */
+            template<typename Rep, typename Period>
+            bool pop_for(MsgType& destination, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->pop_until(destination, std::chrono::steady_clock::now() + timeout);
+            }
+
+            /** \brief Function that takes up to max messages from the queue in one go.
+             *
+             * \param destination OutputIt Iterator to write (move) the messages to, e.g. a std::back_inserter.
+             * \param max std::size_t Maximum number of messages to take.
+             * \return std::size_t Number of messages taken; at least one unless max is zero.
+             *
+             * \note Function blocks until thread-safe access to the queue is possible and at least one message arrived.
+             */
+            template<typename OutputIt>
+            std::size_t pop_bulk(OutputIt destination, std::size_t max)
+            {
+                if (max == 0)
+                {
+                    return 0;
+                }
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__waitCondition.wait(lock, [this]()->bool
+                {
+                    return !this->__storage.empty();
+                });
+                return this->__take(destination, max);
+            }
+
+            /** \brief Function that moves all messages that are currently available to the end of the given container.
+             *
+             * \param container Container& Container offering push_back(), e.g. std::vector or std::deque.
+             * \return std::size_t Number of messages taken, possibly zero.
+             *
+             * \note Function blocks until thread-safe access to the queue is possible, but does not wait for messages.
+             */
+            template<typename Container>
+            std::size_t drain_into(Container& container)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                return this->__take(std::back_inserter(container), static_cast<std::size_t>(-1));
+            }
+
             void clear()
             {
                 std::unique_lock<std::mutex> lock(this->__accessMutex);
-                Storage<MsgType, OptArgs...> empty; // empty storage
-                std::swap(this->__storage, empty);
+                if_member_clear< detect::has_member_clear<storage_type>::value, storage_type >::exec(this->__storage);
+                if (is_bounded)
+                {
+                    this->__notFullCondition.notify_all();
+                }
             }
 
             void swap(queue& rhs) 
@@ -95,6 +362,30 @@ namespace concurrent
                 std::unique_lock<std::mutex> lock(this->__accessMutex);
                 std::unique_lock<std::mutex> lock2(rhs.__accessMutex);
                 std::swap(this->__storage, rhs.__storage);
+                if (is_bounded)
+                {
+                    this->__notFullCondition.notify_all();
+                    rhs.__notFullCondition.notify_all();
+                }
+            }
+
+            /** \brief Sets how threads wait for messages (and for room, in case of bounded storage) before they get parked.
+             *
+             * \param strategy const wait_strategy& E.g. wait_strategy::latency_optimized() or wait_strategy::cpu_friendly().
+             * \return *this
+             */
+            queue& set_wait_strategy(const wait_strategy& strategy)
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                this->__waitCondition.set_strategy(strategy);
+                this->__notFullCondition.set_strategy(strategy);
+                return *this;
+            }
+
+            wait_strategy get_wait_strategy() const
+            {
+                std::unique_lock<std::mutex> lock(this->__accessMutex);
+                return this->__waitCondition.strategy();
             }
 
         private:
@@ -103,9 +394,423 @@ namespace concurrent
             queue& operator=(const queue& rhs);     /**< queues must not be assigned to other channels */
             // Parameters
             mutable std::mutex __accessMutex;
-            std::condition_variable __waitCondition;
-            Storage<MsgType, OptArgs...> __storage;
+            internal::parking_condition __waitCondition;
+            internal::parking_condition __notFullCondition; /**< Only used in case of bounded storage */
+            storage_type __storage;
+
+            bool __full() const
+            {
+                return if_member_full<is_bounded, storage_type>::exec(this->__storage);
+            }
+
+            void __wait_not_full(std::unique_lock<std::mutex>& lock)
+            {
+                if (is_bounded)
+                {
+                    this->__notFullCondition.wait(lock, [this]()->bool
+                    {
+                        return !this->__full();
+                    });
+                }
+            }
+
+            /** \brief Waits until there is room for a message or the deadline passed. Lock has to be held by the caller.
+             *
+             * \return bool "true" if there is room.
+             */
+            template<typename Clock, typename Duration>
+            bool __wait_not_full_until(std::unique_lock<std::mutex>& lock, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                if (!is_bounded)
+                {
+                    return true;
+                }
+                return this->__notFullCondition.wait_until(lock, deadline, [this]()->bool
+                {
+                    return !this->__full();
+                });
+            }
+
+            void __notify_not_full()
+            {
+                if (is_bounded)
+                {
+                    this->__notFullCondition.notify_one();
+                }
+            }
+
+            /** \brief Wakes up as many consumers as there are new messages, using a single notification.
+             */
+            void __notify_pushed(std::size_t pushed)
+            {
+                if (pushed == 1)
+                {
+                    this->__waitCondition.notify_one();
+                }
+                else if (pushed > 1)
+                {
+                    this->__waitCondition.notify_all();
+                }
+            }
+
+            /** \brief Moves up to max messages to destination. Lock has to be held by the caller.
+             */
+            template<typename OutputIt>
+            std::size_t __take(OutputIt destination, std::size_t max)
+            {
+                std::size_t taken = 0;
+                while (taken < max && !this->__storage.empty())
+                {
+                    *destination++ = std::move(this->__storage.front());
+                    this->__storage.pop();
+                    ++taken;
+                }
+                if (is_bounded && taken == 1)
+                {
+                    this->__notFullCondition.notify_one();
+                }
+                else if (is_bounded && taken > 1)
+                {
+                    this->__notFullCondition.notify_all();
+                }
+                return taken;
+            }
+
+    };
+
+    template<typename MsgType, template<typename, typename...> class Storage, typename... OptArgs>
+    const bool queue<MsgType, Storage, OptArgs...>::is_bounded;
+
+    /** \brief Lock-free version of the concurrent queue, selected by using concurrent::mpmc_ring as storage.
+     *         It offers the same interface, but push and pop do not acquire any lock as long as they do not have to wait.
+     *         Threads only get parked (see concurrent::internal::waiter) if the queue is empty (pop) or full (push).
+     *  \param MsgType Type of the messages that are exchanged between the communications partners.
+     *  \param OptArgs Optional arguments that are getting passed to the ring declaration, e.g. for a custom allocator.
+     *  \note Since the ring is bounded, push() blocks while the queue is full, like it does on other bounded storage.
+     *  \note pop() and pop_bulk() require MsgType to be default-constructible, since messages are moved out of the ring into an existing object.
+     */
+    template<typename MsgType, typename... OptArgs>
+    class queue<MsgType, mpmc_ring, OptArgs...>
+    {
+        static_assert( std::is_move_constructible<MsgType>::value, "The message type requires to be move-constructible!" );
+
+        typedef mpmc_ring<MsgType, OptArgs...> storage_type;
+
+        public:
+            queue(){};
+
+            /** \brief C'tor.
+             *
+             * \param capacity std::size_t Maximum number of messages that may be queued at the same time (rounded up to a power of two).
+             */
+            explicit queue(std::size_t capacity) : __storage(new storage_type(capacity)) {};
+
+            /** \brief C'tor that hands an allocator over to the ring, which uses it for its slot buffer.
+             *
+             * \param alloc const Alloc& Allocator (or anything the ring's allocator can be constructed from).
+             * \param capacity std::size_t Maximum number of messages that may be queued at the same time (rounded up to a power of two).
+             */
+            template<typename Alloc>
+            queue(std::allocator_arg_t, const Alloc& alloc, std::size_t capacity = storage_type::default_capacity)
+                : __storage(new storage_type(capacity, alloc)) {};
+            ~queue(){};
+
+            /** \brief Function that adds a message to the queue. Message is taken as reference.
+            *
+            * \param msg const MsgType Message to be added to the queue.
+            * \return *this
+            *
+            * \note Function blocks until there is room for the message.
+            */
+            queue& push(const MsgType& msg)
+            {
+                this->__notFull.wait([&]()->bool { return this->__storage->try_push(msg); });
+                this->__notEmpty.notify_one();
+                return *this;
+            }
+
+            /** \brief Function that adds a message to the message-queue. Message is taken as r-value.
+            *
+            * \param msg MsgType&& Message to be added to the queue.
+            * \return *this
+            *
+            * \note Function blocks until there is room for the message.
+            */
+            queue& push(MsgType&& msg)
+            {
+                this->__notFull.wait([&]()->bool { return this->__storage->try_push(std::move(msg)); });
+                this->__notEmpty.notify_one();
+                return *this;
+            }
+
+            /** \brief Function that constructs a message in place at the end of the queue.
+            *
+            * \param args Args&&... Arguments that are forwarded to the constructor of MsgType.
+            * \return *this
+            *
+            * \note Function blocks until there is room for the message; the message is only constructed once there is.
+            */
+            template<typename... Args>
+            queue& emplace(Args&&... args)
+            {
+                this->__notFull.wait([&]()->bool { return this->__storage->try_emplace(std::forward<Args>(args)...); });
+                this->__notEmpty.notify_one();
+                return *this;
+            }
+
+            /** \brief Function that adds a message to the queue if there is room for it. Message is taken as reference.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \return bool "true" if the message was added, "false" if the queue is full.
+            */
+            bool try_push(const MsgType& msg)
+            {
+                if (!this->__storage->try_push(msg))
+                {
+                    return false;
+                }
+                this->__notEmpty.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue if there is room for it. Message is taken as r-value.
+            *
+            * \param msg MsgType&& Message to be added to the queue.
+            * \return bool "true" if the message was added, "false" if the queue is full. In the latter case, msg is left untouched.
+            */
+            bool try_push(MsgType&& msg)
+            {
+                if (!this->__storage->try_push(std::move(msg)))
+                {
+                    return false;
+                }
+                this->__notEmpty.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue, waiting for room at most until the given deadline.
+            *
+            * \param msg const MsgType& Message to be added to the queue.
+            * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+            * \return bool "true" if the message was added, "false" if the queue was still full at the deadline.
+            */
+            template<typename Clock, typename Duration>
+            bool push_until(const MsgType& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                if (!this->__notFull.wait_until([&]()->bool { return this->__storage->try_push(msg); }, deadline))
+                {
+                    return false;
+                }
+                this->__notEmpty.notify_one();
+                return true;
+            }
+
+            /** \brief Function that adds a message to the queue, waiting for room at most until the given deadline. Message is taken as r-value.
+            *
+            * \return bool "true" if the message was added, "false" on timeout. In the latter case, msg is left untouched.
+            */
+            template<typename Clock, typename Duration>
+            bool push_until(MsgType&& msg, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                if (!this->__notFull.wait_until([&]()->bool { return this->__storage->try_push(std::move(msg)); }, deadline))
+                {
+                    return false;
+                }
+                this->__notEmpty.notify_one();
+                return true;
+            }
+
+            template<typename Rep, typename Period>
+            bool push_for(const MsgType& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->push_until(msg, std::chrono::steady_clock::now() + timeout);
+            }
+
+            template<typename Rep, typename Period>
+            bool push_for(MsgType&& msg, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->push_until(std::move(msg), std::chrono::steady_clock::now() + timeout);
+            }
 
+            /** \brief Function that adds a sequence of messages to the queue, waking up waiting consumers only once for the whole batch.
+            *
+            * \param first InputIt Begin of the sequence. Use std::make_move_iterator to move the messages into the queue.
+            * \param last InputIt End of the sequence.
+            * \return *this
+            *
+            * \note Function blocks whenever the queue gets full in between; the part of the batch that was already added is
+            *       handed over to the consumers before.
+            */
+            template<typename InputIt>
+            queue& push_bulk(InputIt first, InputIt last)
+            {
+                for (; first != last; ++first)
+                {
+                    if (!this->__storage->try_push(*first))
+                    {
+                        this->__notEmpty.notify_all();
+                        this->__notFull.wait([&]()->bool { return this->__storage->try_push(*first); });
+                    }
+                }
+                this->__notEmpty.notify_all();
+                return *this;
+            }
+
+            /** \brief Function that adds all messages of a range (anything that supports std::begin/std::end) to the queue.
+            *
+            * \param range const Range& Messages to add.
+            * \return *this
+            * \see push_bulk(InputIt, InputIt)
+            */
+            template<typename Range>
+            queue& push_bulk(const Range& range)
+            {
+                return this->push_bulk(std::begin(range), std::end(range));
+            }
+
+            /** \brief Function that takes the next available message from the internal message queue.
+             *
+             * \return The message.
+             *
+             * \note Function blocks until at least one message arrived.
+             */
+            MsgType pop()
+            {
+                MsgType destination;
+                this->__notEmpty.wait([&]()->bool { return this->__storage->try_pop(destination); });
+                this->__notFull.notify_one();
+                return destination;
+            }
+
+            /** \brief Function that takes the next available message, waiting for one at most until the given deadline.
+             *
+             * \param destination MsgType& Variable to write the message to.
+             * \param deadline const std::chrono::time_point<Clock, Duration>& Point in time to give up at.
+             * \return bool "true" if a message was taken, "false" if the queue was still empty at the deadline.
+             */
+            template<typename Clock, typename Duration>
+            bool pop_until(MsgType& destination, const std::chrono::time_point<Clock, Duration>& deadline)
+            {
+                if (!this->__notEmpty.wait_until([&]()->bool { return this->__storage->try_pop(destination); }, deadline))
+                {
+                    return false;
+                }
+                this->__notFull.notify_one();
+                return true;
+            }
+
+            template<typename Rep, typename Period>
+            bool pop_for(MsgType& destination, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                return this->pop_until(destination, std::chrono::steady_clock::now() + timeout);
+            }
+
+            /** \brief Function that takes up to max messages from the queue in one go.
+             *
+             * \param destination OutputIt Iterator to write (move) the messages to, e.g. a std::back_inserter.
+             * \param max std::size_t Maximum number of messages to take.
+             * \return std::size_t Number of messages taken; at least one unless max is zero.
+             *
+             * \note Function blocks until at least one message arrived.
+             */
+            template<typename OutputIt>
+            std::size_t pop_bulk(OutputIt destination, std::size_t max)
+            {
+                if (max == 0)
+                {
+                    return 0;
+                }
+                MsgType msg;
+                this->__notEmpty.wait([&]()->bool { return this->__storage->try_pop(msg); });
+                *destination++ = std::move(msg);
+                std::size_t taken = 1 + this->__take(destination, max - 1);
+                if (taken == 1)
+                {
+                    this->__notFull.notify_one(); // __take() only notifies if it took something itself.
+                }
+                return taken;
+            }
+
+            /** \brief Function that moves all messages that are currently available to the end of the given container.
+             *
+             * \param container Container& Container offering push_back(), e.g. std::vector or std::deque.
+             * \return std::size_t Number of messages taken, possibly zero.
+             */
+            template<typename Container>
+            std::size_t drain_into(Container& container)
+            {
+                return this->__take(std::back_inserter(container), static_cast<std::size_t>(-1));
+            }
+
+            /** \brief Drops all messages that are currently queued.
+             *
+             * \note In contrast to the locking version, messages that are added concurrently may survive.
+             */
+            void clear()
+            {
+                MsgType dropped;
+                while (this->__storage->try_pop(dropped)) {}
+                this->__notFull.notify_all();
+            }
+
+            /** \brief Exchanges the content of both queues.
+             *
+             * \note Unlike the locking version, this is NOT safe while other threads access one of the queues.
+             */
+            void swap(queue& rhs) 
+            {
+                std::swap(this->__storage, rhs.__storage);
+                this->__notEmpty.notify_all();
+                rhs.__notEmpty.notify_all();
+                this->__notFull.notify_all();
+                rhs.__notFull.notify_all();
+            }
+
+            /** \brief Sets how threads wait for messages and for room before they get parked.
+             *
+             * \param strategy const wait_strategy& E.g. wait_strategy::latency_optimized() or wait_strategy::cpu_friendly().
+             * \return *this
+             * \note Has to be called before the queue is shared between threads.
+             */
+            queue& set_wait_strategy(const wait_strategy& strategy)
+            {
+                this->__notEmpty.set_strategy(strategy);
+                this->__notFull.set_strategy(strategy);
+                return *this;
+            }
+
+            wait_strategy get_wait_strategy() const
+            {
+                return this->__notEmpty.strategy();
+            }
+
+        private:
+            // Prohibitions
+            queue(const queue& rhs);                /**< queues must not be copied */
+            queue& operator=(const queue& rhs);     /**< queues must not be assigned to other channels */
+            // Parameters
+            std::unique_ptr<storage_type> __storage { new storage_type() };
+            internal::waiter __notEmpty;            /**< Consumers waiting for messages */
+            internal::waiter __notFull;             /**< Producers waiting for room */
+
+            /** \brief Moves up to max messages that are available without waiting to destination.
+             */
+            template<typename OutputIt>
+            std::size_t __take(OutputIt destination, std::size_t max)
+            {
+                std::size_t taken = 0;
+                MsgType msg;
+                while (taken < max && this->__storage->try_pop(msg))
+                {
+                    *destination++ = std::move(msg);
+                    ++taken;
+                }
+                if (taken > 0)
+                {
+                    this->__notFull.notify_all();
+                }
+                return taken;
+            }
     };
 
     // Not usable yet in VS 2012, may available somewhere else
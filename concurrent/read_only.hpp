@@ -0,0 +1,66 @@
+#ifndef __CONCURRENT_READ_ONLY_HPP__
+#define __CONCURRENT_READ_ONLY_HPP__
+
+#include <type_traits>
+#include <utility>
+
+#include "util/detect.hpp"
+
+namespace concurrent
+{
+    /** \brief Functor wrapper that passes the value on as const, marking the functor as read-only for objects that run
+     *         readers concurrently. Created by read_only().
+     *
+     *  \param F Type of the wrapped functor.
+     */
+    template<typename F>
+    struct read_only_functor
+    {
+        F f;
+
+        template<typename U>
+        auto operator()(const U& value) -> decltype(std::declval<F&>()(value))
+        {
+            return this->f(value);
+        }
+    };
+
+    /** \brief Marks a functor as read-only, e.g. a generic lambda that is not recognized as such by its signature:
+     *
+     *         obj <= concurrent::read_only([](const auto& v) { return v.size(); });
+     *
+     * \param f F Functor; it is called with a const reference to the value.
+     * \return read_only_functor<F> Wrapped functor.
+     */
+    template<typename F>
+    read_only_functor<typename std::decay<F>::type> read_only(F&& f)
+    {
+        return read_only_functor<typename std::decay<F>::type>{ std::forward<F>(f) };
+    }
+
+    namespace internal
+    {
+        template<typename F, typename T>
+        struct read_only_check
+        {
+            static const bool value = detect::is_read_only_functor<F, T>::value;
+        };
+
+        template<typename F, typename T>
+        struct read_only_check<read_only_functor<F>, T>
+        {
+            static const bool value = true;
+        };
+    }
+
+    /** \brief Checks whether a functor only reads the T it is called with: either it takes a const T& (and nothing else), or
+     *         it was wrapped by read_only().
+     */
+    template<typename F, typename T>
+    struct is_read_only
+    {
+        static const bool value = internal::read_only_check<typename std::decay<F>::type, T>::value;
+    };
+}
+
+#endif // !__CONCURRENT_READ_ONLY_HPP__
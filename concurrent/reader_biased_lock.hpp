@@ -0,0 +1,134 @@
+#ifndef __CONCURRENT_READER_BIASED_LOCK_HPP__
+#define __CONCURRENT_READER_BIASED_LOCK_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrent/internal/cache_line.hpp"
+#include "concurrent/internal/waiter.hpp"
+#include "concurrent/wait_strategy.hpp"
+
+namespace concurrent
+{
+    /** \brief Reader/writer lock for data that is read far more often than it is written. Readers do not share a counter:
+     *         each thread registers in one of several reader slots, one cache line each, so readers on different cores do
+     *         not bounce a cache line between them the way they do with a single shared count (like std::shared_mutex).
+     *         The price is paid by writers, which have to check every slot.
+     *         Writers take precedence: once a writer announced itself, new readers wait until it is done.
+     *         Satisfies SharedMutex as far as lock(), unlock(), lock_shared() and unlock_shared() go, thus it works with
+     *         std::lock_guard, std::unique_lock and std::shared_lock.
+     *
+     *  \note Not recursive. Memory: one cache line per hardware thread.
+     */
+    class reader_biased_lock
+    {
+        public:
+            /** \brief C'tor.
+             *
+             * \param strategy const wait_strategy& How readers and writers wait for each other before they park.
+             */
+            explicit reader_biased_lock(const wait_strategy& strategy = wait_strategy::balanced())
+                : __slots(__num_slots()), __writer(false)
+            {
+                for (auto& slot : this->__slots)
+                {
+                    slot.readers.store(0, std::memory_order_relaxed);
+                }
+                this->__released.set_strategy(strategy);
+                this->__drained.set_strategy(strategy);
+            }
+
+            void lock_shared()
+            {
+                std::atomic<std::size_t>& readers = this->__slot();
+                while (true)
+                {
+                    // Announce first, check for a writer afterwards; the writer does it the other way round (both seq_cst).
+                    readers.fetch_add(1, std::memory_order_seq_cst);
+                    if (!this->__writer.load(std::memory_order_seq_cst))
+                    {
+                        return;
+                    }
+                    readers.fetch_sub(1, std::memory_order_seq_cst);
+                    this->__drained.notify_one();
+                    this->__released.wait([this]() -> bool { return !this->__writer.load(std::memory_order_acquire); });
+                }
+            }
+
+            void unlock_shared()
+            {
+                this->__slot().fetch_sub(1, std::memory_order_seq_cst);
+                if (this->__writer.load(std::memory_order_seq_cst))
+                {
+                    this->__drained.notify_one();
+                }
+            }
+
+            void lock()
+            {
+                this->__writerLock.lock();
+                this->__writer.store(true, std::memory_order_seq_cst);
+                this->__drained.wait([this]() -> bool { return this->__no_readers(); });
+            }
+
+            void unlock()
+            {
+                this->__writer.store(false, std::memory_order_seq_cst);
+                this->__writerLock.unlock();
+                this->__released.notify_all();
+            }
+
+        private:
+            // Prohibitions
+            reader_biased_lock(const reader_biased_lock& rhs);
+            reader_biased_lock& operator=(const reader_biased_lock& rhs);
+
+            struct alignas(cache_line_size) slot
+            {
+                std::atomic<std::size_t> readers;
+            };
+
+            std::vector<slot> __slots;                  /**< Power of two of them, so a thread's slot is a mask away */
+            alignas(cache_line_size) std::atomic<bool> __writer;
+            std::mutex __writerLock;                    /**< Serializes writers */
+            internal::waiter __released;                /**< Readers waiting for a writer to finish */
+            internal::waiter __drained;                 /**< The writer waiting for readers to leave */
+
+            static std::size_t __num_slots()
+            {
+                std::size_t wanted = std::thread::hardware_concurrency();
+                std::size_t n = 1;
+                while (n < wanted)
+                {
+                    n <<= 1;
+                }
+                return n;
+            }
+
+            /** \brief Reader slot of the calling thread. Threads are numbered in the order they first use any such lock.
+             */
+            std::atomic<std::size_t>& __slot()
+            {
+                static std::atomic<std::size_t> nextThread(0);
+                static thread_local std::size_t thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+                return this->__slots[thread & (this->__slots.size() - 1)].readers;
+            }
+
+            bool __no_readers() const
+            {
+                for (const auto& slot : this->__slots)
+                {
+                    if (slot.readers.load(std::memory_order_seq_cst) != 0)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+    };
+}
+
+#endif // !__CONCURRENT_READER_BIASED_LOCK_HPP__
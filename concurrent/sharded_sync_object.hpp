@@ -0,0 +1,272 @@
+#ifndef __CONCURRENT_SHARDED_SYNC_OBJECT_HPP__
+#define __CONCURRENT_SHARDED_SYNC_OBJECT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent/internal/cache_line.hpp"
+#include "concurrent/sync_object.hpp"
+
+namespace concurrent
+{
+    /** \brief Synchronous monitor for keyed containers (like std::unordered_map) that spreads its elements over several
+     *         independently locked containers, the shards. The shard of a key is selected by its hash, thus functors for keys
+     *         in different shards run concurrently, while a single sync_object would serialize all of them:
+     *
+     *         concurrent::sharded_sync_object<std::unordered_map<std::string, int>> counts;
+     *         counts["apple"] <= [](std::unordered_map<std::string, int>& shard) { ++shard["apple"]; };
+     *         auto n = counts["pear"] <= [](const std::unordered_map<std::string, int>& shard) { return shard.count("pear"); };
+     *         auto total = counts <= [](concurrent::shard_range<std::unordered_map<std::string, int>>& shards) {
+     *             std::size_t sum = 0;
+     *             for (auto& shard : shards) { sum += shard.size(); }
+     *             return sum;
+     *         };
+     *
+     *         A functor sent for a key gets the shard of that key, so it has to look up the key itself; it must not touch
+     *         other keys, since they may live in other shards. A functor sent to the object as a whole gets all shards,
+     *         locked one after the other in a fixed order, thus such functors cannot deadlock with each other.
+     *         As with sync_object, results come back as expected::value, and read-only functors share the lock of their
+     *         shard if the lock offers shared access.
+     *
+     *  \param Container Keyed container type; each shard holds one.
+     *  \param Hash Hash of the keys; std::hash<Container::key_type> by default.
+     *  \param Lock Lock type of each shard; std::mutex by default.
+     */
+    template<typename Container, typename Hash = std::hash<typename Container::key_type>, typename Lock = std::mutex>
+    class sharded_sync_object;
+
+    /** \brief All shards of a sharded_sync_object, as handed to functors sent to the object as a whole. Iterating it yields
+     *         the containers of the shards, in the order they are locked in.
+     */
+    template<typename Container>
+    class shard_range
+    {
+        public:
+            class iterator
+            {
+                public:
+                    iterator(Container* const* position) : __position(position) {}
+
+                    Container& operator*() const
+                    {
+                        return **this->__position;
+                    }
+
+                    iterator& operator++()
+                    {
+                        ++this->__position;
+                        return *this;
+                    }
+
+                    bool operator==(const iterator& rhs) const
+                    {
+                        return this->__position == rhs.__position;
+                    }
+
+                    bool operator!=(const iterator& rhs) const
+                    {
+                        return this->__position != rhs.__position;
+                    }
+
+                private:
+                    Container* const* __position;
+            };
+
+            std::size_t size() const
+            {
+                return this->__size;
+            }
+
+            Container& operator[](std::size_t index) const
+            {
+                return *this->__shards[index];
+            }
+
+            iterator begin() const
+            {
+                return iterator(this->__shards.get());
+            }
+
+            iterator end() const
+            {
+                return iterator(this->__shards.get() + this->__size);
+            }
+
+        private:
+            template<typename C, typename H, typename L>
+            friend class sharded_sync_object;
+
+            explicit shard_range(std::size_t size) : __shards(new Container*[size]), __size(size) {}
+
+            // Prohibitions
+            shard_range(const shard_range& rhs);
+            shard_range& operator=(const shard_range& rhs);
+
+            std::unique_ptr<Container*[]> __shards;
+            std::size_t __size;
+    };
+
+    template<typename Container, typename Hash, typename Lock>
+    class sharded_sync_object
+    {
+        private:
+            struct alignas(cache_line_size) shard
+            {
+                Container value;
+                Lock lock;
+            };
+
+        public:
+            static const std::size_t default_shards = 16;
+
+            /** \brief Functors sent through it are executed on the shard of a key; returned by operator[].
+             */
+            class shard_access
+            {
+                public:
+                    /** \brief Executes a functor on the shard of the key, taking the shard's lock.
+                     *
+                     * \param f F Functor to execute; it gets the shard's Container.
+                     * \return Anything that the functor returns.
+                     * \note This function will block until the lock could be acquired.
+                     */
+                    template<typename F>
+                    auto operator <= (F&& f) const -> expected::value<decltype(f(std::declval<Container&>()))>
+                    {
+                        return __apply(this->__shard, f, std::integral_constant<bool, is_read_only<F, Container>::value && detect::has_member_lock_shared<Lock>::value>());
+                    }
+
+                private:
+                    friend class sharded_sync_object;
+
+                    explicit shard_access(shard& s) : __shard(s) {}
+
+                    shard& __shard;
+            };
+
+            /** \brief C'tor.
+             *
+             * \param numShards std::size_t Number of shards; rounded up to a power of two. 0 is treated as 1.
+             * \param hash const Hash& Hash of the keys.
+             */
+            explicit sharded_sync_object(std::size_t numShards = default_shards, const Hash& hash = Hash())
+                : __numShards(__round_up(numShards)), __shards(new shard[__round_up(numShards)]), __hash(hash)
+            {
+
+            }
+
+            /** \brief D'tor. It acquires every lock to ensure that no-one is still using the shards.
+             */
+            ~sharded_sync_object()
+            {
+                for (std::size_t i = 0; i < this->__numShards; ++i)
+                {
+                    std::lock_guard<Lock> guard(this->__shards[i].lock);
+                }
+            }
+
+            /** \brief Selects the shard of a key; send a functor to the result to execute it on that shard.
+             *
+             * \param key const typename Container::key_type& Key whose shard should be selected.
+             * \return shard_access
+             */
+            shard_access operator[](const typename Container::key_type& key) const
+            {
+                return shard_access(this->__shards[this->shard_of(key)]);
+            }
+
+            /** \brief Executes a functor on all shards, after locking all of them in the order of their indices.
+             *
+             * \param f F Functor to execute; it gets a shard_range<Container>&.
+             * \return Anything that the functor returns.
+             * \note This function will block until all locks could be acquired. All shards are locked exclusively.
+             */
+            template<typename F>
+            auto operator <= (F&& f) const -> expected::value<decltype(f(std::declval<shard_range<Container>&>()))>
+            {
+                shard_range<Container> range(this->__numShards);
+                std::size_t locked = 0;
+                try
+                {
+                    for (; locked < this->__numShards; ++locked)
+                    {
+                        this->__shards[locked].lock.lock();
+                        range.__shards[locked] = &this->__shards[locked].value;
+                    }
+                }
+                catch (...)
+                {
+                    __unlock(this->__shards.get(), locked);
+                    throw;
+                }
+                auto res = expected::result_of([&]() { return f(range); } );
+                __unlock(this->__shards.get(), locked);
+                return res;
+            }
+
+            /** \brief Index of the shard a key belongs to, in [0, shards()).
+             */
+            std::size_t shard_of(const typename Container::key_type& key) const
+            {
+                // Fibonacci hashing: spreads hashes that differ in their high bits only (like pointers) over all shards.
+                std::uint64_t mixed = static_cast<std::uint64_t>(this->__hash(key)) * 0x9E3779B97F4A7C15ull;
+                return static_cast<std::size_t>(mixed >> 32) & (this->__numShards - 1);
+            }
+
+            std::size_t shards() const
+            {
+                return this->__numShards;
+            }
+
+        private:
+            // Prohibitions
+            sharded_sync_object(const sharded_sync_object& rhs);
+            sharded_sync_object& operator=(const sharded_sync_object& rhs);
+
+            std::size_t __numShards;
+            std::unique_ptr<shard[]> __shards;
+            Hash __hash;
+
+            template<typename F>
+            static auto __apply(shard& s, F& f, std::false_type /* exclusive */) -> expected::value<decltype(f(std::declval<Container&>()))>
+            {
+                std::lock_guard<Lock> guard(s.lock);
+                auto res = expected::result_of([&]() { return f(s.value); } );
+                return res;
+            }
+
+            template<typename F>
+            static auto __apply(shard& s, F& f, std::true_type /* shared */) -> expected::value<decltype(f(std::declval<Container&>()))>
+            {
+                internal::shared_guard<Lock> guard(s.lock);
+                const Container& value = s.value;
+                auto res = expected::result_of([&]() { return f(value); } );
+                return res;
+            }
+
+            static void __unlock(shard* shards, std::size_t count)
+            {
+                while (count > 0)
+                {
+                    shards[--count].lock.unlock();
+                }
+            }
+
+            static std::size_t __round_up(std::size_t wanted)
+            {
+                std::size_t n = 1;
+                while (n < wanted)
+                {
+                    n <<= 1;
+                }
+                return n;
+            }
+    };
+}
+
+#endif // !__CONCURRENT_SHARDED_SYNC_OBJECT_HPP__
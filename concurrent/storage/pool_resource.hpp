@@ -0,0 +1,172 @@
+#ifndef __CONCURRENT_STORAGE_POOL_RESOURCE_HPP__
+#define __CONCURRENT_STORAGE_POOL_RESOURCE_HPP__
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+
+#define CONCURRENT_HAS_PMR 1
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <queue>
+
+#include "concurrent/storage/ring_buffer.hpp"
+
+namespace concurrent
+{
+    /** \brief Snapshot of the memory used by a pool_resource.
+     */
+    struct memory_stats
+    {
+        std::size_t bytes_in_use;           /**< Bytes currently handed out to the storage */
+        std::size_t peak_bytes_in_use;      /**< Maximum of bytes_in_use since construction */
+        std::size_t bytes_reserved;         /**< Bytes currently held from the upstream resource, including free pool blocks */
+        std::size_t upstream_allocations;   /**< Number of allocations the pool had to request from upstream so far */
+    };
+
+    /** \brief Pool resource for the nodes of a queue's or channel's storage. Freed nodes are kept in size-segregated pools
+     *         and handed out again, so once the storage has grown to its working set, steady message traffic does not
+     *         allocate from the upstream resource (i.e. malloc) any more. It also keeps track of the memory it manages,
+     *         which makes the memory usage of every queue or channel that has a pool of its own measurable.
+     *
+     *         concurrent::pool_resource pool;
+     *         concurrent::channel<int, concurrent::pmr::deque_storage> ch(std::allocator_arg, &pool);
+     *         ...
+     *         std::size_t bytes = pool.stats().bytes_reserved;
+     *
+     *  \note The pool itself is not synchronized, which is sufficient for the locking queue and channel, since they only
+     *        touch their storage while holding their lock. Do not share one pool between several of them; stats() may be
+     *        called from any thread, though.
+     *  \note The pool has to outlive the storage that uses it.
+     */
+    class pool_resource : public std::pmr::memory_resource
+    {
+        public:
+            /** \brief C'tor.
+             *
+             * \param upstream std::pmr::memory_resource* Resource the pool gets its blocks from.
+             */
+            explicit pool_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+                : __upstream(upstream), __pool(&__upstream), __inUse(0), __peak(0) {}
+
+            /** \brief C'tor.
+             *
+             * \param options const std::pmr::pool_options& Size of the largest pooled block and of the chunks requested from upstream.
+             * \param upstream std::pmr::memory_resource* Resource the pool gets its blocks from.
+             */
+            pool_resource(const std::pmr::pool_options& options, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+                : __upstream(upstream), __pool(options, &__upstream), __inUse(0), __peak(0) {}
+
+            memory_stats stats() const
+            {
+                memory_stats result;
+                result.bytes_in_use = this->__inUse.load(std::memory_order_relaxed);
+                result.peak_bytes_in_use = this->__peak.load(std::memory_order_relaxed);
+                result.bytes_reserved = this->__upstream.reserved.load(std::memory_order_relaxed);
+                result.upstream_allocations = this->__upstream.allocations.load(std::memory_order_relaxed);
+                return result;
+            }
+
+            /** \brief Returns all blocks to the upstream resource. Must only be called if none of them is in use any more.
+             */
+            void release()
+            {
+                this->__pool.release();
+            }
+
+            std::pmr::memory_resource* upstream_resource() const
+            {
+                return this->__upstream.upstream;
+            }
+
+        protected:
+            void* do_allocate(std::size_t bytes, std::size_t alignment)
+            {
+                void* result = this->__pool.allocate(bytes, alignment);
+                std::size_t inUse = this->__inUse.load(std::memory_order_relaxed) + bytes;
+                this->__inUse.store(inUse, std::memory_order_relaxed); // Only written by the (single) owner of the pool.
+                if (inUse > this->__peak.load(std::memory_order_relaxed))
+                {
+                    this->__peak.store(inUse, std::memory_order_relaxed);
+                }
+                return result;
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+            {
+                this->__pool.deallocate(p, bytes, alignment);
+                this->__inUse.store(this->__inUse.load(std::memory_order_relaxed) - bytes, std::memory_order_relaxed);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept
+            {
+                return this == &other;
+            }
+
+        private:
+            // Prohibitions
+            pool_resource(const pool_resource& rhs);
+            pool_resource& operator=(const pool_resource& rhs);
+
+            /** \brief Forwards to the actual upstream resource and counts what passes through.
+             */
+            struct counting_resource : std::pmr::memory_resource
+            {
+                explicit counting_resource(std::pmr::memory_resource* up) : upstream(up), reserved(0), allocations(0) {}
+
+                void* do_allocate(std::size_t bytes, std::size_t alignment)
+                {
+                    void* result = this->upstream->allocate(bytes, alignment);
+                    this->reserved.store(this->reserved.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+                    this->allocations.store(this->allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return result;
+                }
+
+                void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+                {
+                    this->upstream->deallocate(p, bytes, alignment);
+                    this->reserved.store(this->reserved.load(std::memory_order_relaxed) - bytes, std::memory_order_relaxed);
+                }
+
+                bool do_is_equal(const std::pmr::memory_resource& other) const noexcept
+                {
+                    return this == &other;
+                }
+
+                std::pmr::memory_resource* upstream;
+                std::atomic<std::size_t> reserved;
+                std::atomic<std::size_t> allocations;
+            };
+
+            counting_resource __upstream;
+            std::pmr::unsynchronized_pool_resource __pool;
+            std::atomic<std::size_t> __inUse;
+            std::atomic<std::size_t> __peak;
+    };
+
+    namespace pmr
+    {
+        /** \brief std::queue on top of a std::pmr::deque, usable as Storage of concurrent::queue and concurrent::channel.
+         *         Construct the queue or channel with (std::allocator_arg, resource) to make it allocate from that resource.
+         */
+        template<typename T, typename...>
+        using deque_storage = std::queue<T, std::pmr::deque<T>>;
+
+        /** \brief concurrent::ring_buffer with a polymorphic allocator; its single slot buffer is taken from the given resource.
+         *  \note The lock-free rings are selected by their exact template name, thus they cannot be aliased. Pass the
+         *        allocator type explicitly instead, e.g. queue<T, mpmc_ring, std::pmr::polymorphic_allocator<T>>.
+         */
+        template<typename T, typename...>
+        using ring_buffer = concurrent::ring_buffer<T, std::pmr::polymorphic_allocator<T>>;
+    }
+}
+
+#endif // __cpp_lib_memory_resource
+
+#endif // !__CONCURRENT_STORAGE_POOL_RESOURCE_HPP__
@@ -0,0 +1,133 @@
+#ifndef __CONCURRENT_STORAGE_PRIORITY_LANES_HPP__
+#define __CONCURRENT_STORAGE_PRIORITY_LANES_HPP__
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+namespace concurrent
+{
+    /** \brief Lane a message is queued in by priority_lanes.
+     */
+    enum class priority
+    {
+        bulk,           /**< Regular work; the default */
+        urgent          /**< Control-plane work that should overtake queued bulk work, like health checks or cancellations */
+    };
+
+    /** \brief Storage that implements the queue policy (push(T), emplace(priority, Args...), pop(), front(), empty() ) on top of
+     *         two FIFO lanes. Messages added by push() go to the bulk lane; emplace() takes the lane as its first argument.
+     *         front() and pop() serve the urgent lane first, so an urgent message only waits for other urgent ones, no matter
+     *         how much bulk work is queued. To keep a steady stream of urgent messages from starving the bulk lane, one bulk
+     *         message is served after every maxUrgentStreak urgent ones in a row while bulk work is pending.
+     *         Within a lane, messages keep their order; across lanes, they do not.
+     *  \param T Type of the elements to store.
+     *  \param Container Container of each lane, offering push_back(), emplace_back(), pop_front() and front().
+     */
+    template<typename T, typename Container = std::deque<T>>
+    class priority_lanes
+    {
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+
+            static const size_type default_max_urgent_streak = 16;
+
+            /** \brief C'tor.
+             *
+             * \param maxUrgentStreak size_type Number of urgent elements served in a row before a pending bulk one gets its turn.
+             *        0 is treated as 1.
+             */
+            explicit priority_lanes(size_type maxUrgentStreak = default_max_urgent_streak)
+                : __urgentStreak(0), __maxUrgentStreak(maxUrgentStreak > 0 ? maxUrgentStreak : 1)
+            {
+
+            }
+
+            void push(const T& value)
+            {
+                this->__bulk.push_back(value);
+            }
+
+            void push(T&& value)
+            {
+                this->__bulk.push_back(std::move(value));
+            }
+
+            /** \brief Constructs an element in place at the end of the given lane.
+             */
+            template<typename... Args>
+            void emplace(priority lane, Args&&... args)
+            {
+                this->__lane(lane).emplace_back(std::forward<Args>(args)...);
+            }
+
+            T& front()
+            {
+                return this->__serve_urgent() ? this->__urgent.front() : this->__bulk.front();
+            }
+
+            const T& front() const
+            {
+                return this->__serve_urgent() ? this->__urgent.front() : this->__bulk.front();
+            }
+
+            void pop()
+            {
+                if (this->__serve_urgent())
+                {
+                    this->__urgent.pop_front();
+                    ++this->__urgentStreak;
+                }
+                else
+                {
+                    this->__bulk.pop_front();
+                    this->__urgentStreak = 0;
+                }
+            }
+
+            bool empty() const
+            {
+                return this->__urgent.empty() && this->__bulk.empty();
+            }
+
+            size_type size() const
+            {
+                return this->__urgent.size() + this->__bulk.size();
+            }
+
+            /** \brief Number of elements queued in the given lane.
+             */
+            size_type size(priority lane) const
+            {
+                return lane == priority::urgent ? this->__urgent.size() : this->__bulk.size();
+            }
+
+            void clear()
+            {
+                this->__urgent.clear();
+                this->__bulk.clear();
+                this->__urgentStreak = 0;
+            }
+
+        private:
+            Container __urgent;
+            Container __bulk;
+            size_type __urgentStreak;           /**< Number of urgent elements served since the last bulk one */
+            size_type __maxUrgentStreak;
+
+            Container& __lane(priority lane)
+            {
+                return lane == priority::urgent ? this->__urgent : this->__bulk;
+            }
+
+            /** \brief Decides which lane front() and pop() refer to; only pop() changes the outcome.
+             */
+            bool __serve_urgent() const
+            {
+                return !this->__urgent.empty() && (this->__bulk.empty() || this->__urgentStreak < this->__maxUrgentStreak);
+            }
+    };
+}
+
+#endif // !__CONCURRENT_STORAGE_PRIORITY_LANES_HPP__
@@ -0,0 +1,242 @@
+#ifndef __CONCURRENT_STORAGE_RING_BUFFER_HPP__
+#define __CONCURRENT_STORAGE_RING_BUFFER_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace concurrent
+{
+    /** \brief Fixed-capacity storage that implements the queue policy (push(T), emplace(Args...), pop(), front(), empty() ) on top of a
+     *         ring of preallocated slots. The whole buffer is allocated once on construction, so adding or removing messages
+     *         never allocates. Since it offers a full() member, concurrent::queue and concurrent::channel consider it to be
+     *         bounded and block their producers as long as no slot is free.
+     *  \param T Type of the elements to store.
+     *  \param Alloc Allocator used for the slot buffer.
+     */
+    template<typename T, typename Alloc = std::allocator<T>>
+    class ring_buffer
+    {
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
+        public:
+            typedef T value_type;
+            typedef Alloc allocator_type;
+            typedef std::size_t size_type;
+
+            static const size_type default_capacity = 1024; /**< Capacity used if none was given explicitly, e.g. on queue::clear() of a default-constructed queue */
+
+            /** \brief C'tor. Allocates the slots for all elements up-front.
+             *
+             * \param capacity size_type Maximum number of elements that may be stored at the same time. Has to be greater than zero.
+             * \param alloc const Alloc& Allocator instance to use.
+             */
+            explicit ring_buffer(size_type capacity = default_capacity, const Alloc& alloc = Alloc())
+                : __alloc(alloc), __slots(nullptr), __capacity(capacity > 0 ? capacity : 1), __head(0), __size(0)
+            {
+                this->__slots = alloc_traits::allocate(this->__alloc, this->__capacity);
+            }
+
+            /** \brief C'tor using the default capacity, e.g. for queues and channels that were constructed with an allocator only.
+             *
+             * \param alloc const Alloc& Allocator instance to use.
+             */
+            explicit ring_buffer(const Alloc& alloc)
+                : __alloc(alloc), __slots(nullptr), __capacity(default_capacity), __head(0), __size(0)
+            {
+                this->__slots = alloc_traits::allocate(this->__alloc, this->__capacity);
+            }
+
+            /** \brief Move c'tor. Takes over the slots of rhs, which is left without any: its capacity is zero, thus it is
+             *         empty and full at once, and may only be destroyed, assigned to or swapped.
+             */
+            ring_buffer(ring_buffer&& rhs)
+                : __alloc(std::move(rhs.__alloc)), __slots(rhs.__slots), __capacity(rhs.__capacity), __head(rhs.__head), __size(rhs.__size)
+            {
+                rhs.__slots = nullptr;
+                rhs.__capacity = 0;
+                rhs.__head = 0;
+                rhs.__size = 0;
+            }
+
+            /** \brief Move assignment. Takes over the slots of rhs, unless the allocators differ and must not be propagated
+             *         (e.g. polymorphic allocators on different resources); then the elements are moved one by one into slots
+             *         of this buffer's allocator. If the slots were taken over, rhs is left like after the move c'tor.
+             */
+            ring_buffer& operator=(ring_buffer&& rhs)
+            {
+                if (this != std::addressof(rhs))
+                {
+                    this->__release();
+                    if (!alloc_traits::propagate_on_container_move_assignment::value && !(this->__alloc == rhs.__alloc))
+                    {
+                        this->__capacity = rhs.__capacity;
+                        this->__head = 0;
+                        this->__size = 0;
+                        this->__slots = alloc_traits::allocate(this->__alloc, this->__capacity);
+                        while (!rhs.empty())
+                        {
+                            this->push(std::move(rhs.front()));
+                            rhs.pop();
+                        }
+                        return *this;
+                    }
+                    __propagate(this->__alloc, rhs.__alloc, typename alloc_traits::propagate_on_container_move_assignment());
+                    this->__slots = rhs.__slots;
+                    this->__capacity = rhs.__capacity;
+                    this->__head = rhs.__head;
+                    this->__size = rhs.__size;
+                    rhs.__slots = nullptr;
+                    rhs.__capacity = 0;
+                    rhs.__head = 0;
+                    rhs.__size = 0;
+                }
+                return *this;
+            }
+
+            ~ring_buffer()
+            {
+                this->__release();
+            }
+
+            void push(const T& value)
+            {
+                this->emplace(value);
+            }
+
+            void push(T&& value)
+            {
+                this->emplace(std::move(value));
+            }
+
+            /** \brief Constructs a new element in place behind the newest one. Must not be called on a full buffer.
+             *
+             * \param args Args&&... Arguments that are forwarded to the constructor of T.
+             */
+            template<typename... Args>
+            void emplace(Args&&... args)
+            {
+                alloc_traits::construct(this->__alloc, this->__slot(this->__size), std::forward<Args>(args)...);
+                ++this->__size;
+            }
+
+            /** \brief Removes the oldest element. Must not be called on an empty buffer.
+             */
+            void pop()
+            {
+                alloc_traits::destroy(this->__alloc, this->__slot(0));
+                this->__head = (this->__head + 1) % this->__capacity;
+                --this->__size;
+            }
+
+            T& front()
+            {
+                return *this->__slot(0);
+            }
+
+            const T& front() const
+            {
+                return *this->__slot(0);
+            }
+
+            bool empty() const
+            {
+                return this->__size == 0;
+            }
+
+            /** \brief Whether no slot is free; always "true" for a buffer that was moved from.
+             */
+            bool full() const
+            {
+                return this->__size == this->__capacity;
+            }
+
+            size_type size() const
+            {
+                return this->__size;
+            }
+
+            size_type capacity() const
+            {
+                return this->__capacity;
+            }
+
+            /** \brief Destroys all elements, but keeps the slots allocated.
+             */
+            void clear()
+            {
+                while (!this->empty())
+                {
+                    this->pop();
+                }
+                this->__head = 0;
+            }
+
+            /** \brief Exchanges the content of both buffers. Allocators are only exchanged if they propagate on swap,
+             *         otherwise they have to be equal.
+             */
+            void swap(ring_buffer& rhs)
+            {
+                using std::swap;
+                __swap_alloc(this->__alloc, rhs.__alloc, typename alloc_traits::propagate_on_container_swap());
+                swap(this->__slots, rhs.__slots);
+                swap(this->__capacity, rhs.__capacity);
+                swap(this->__head, rhs.__head);
+                swap(this->__size, rhs.__size);
+            }
+
+        private:
+            // Prohibitions
+            ring_buffer(const ring_buffer& rhs);                /**< Slots are owned exclusively */
+            ring_buffer& operator=(const ring_buffer& rhs);     /**< Slots are owned exclusively */
+
+            Alloc __alloc;
+            T* __slots;
+            size_type __capacity;
+            size_type __head;                               /**< Index of the oldest element */
+            size_type __size;                               /**< Number of stored elements */
+
+            T* __slot(size_type offset) const
+            {
+                return this->__slots + (this->__head + offset) % this->__capacity;
+            }
+
+            static void __propagate(Alloc& lhs, Alloc& rhs, std::true_type)
+            {
+                lhs = std::move(rhs);
+            }
+
+            static void __propagate(Alloc&, Alloc&, std::false_type) {}
+
+            static void __swap_alloc(Alloc& lhs, Alloc& rhs, std::true_type)
+            {
+                using std::swap;
+                swap(lhs, rhs);
+            }
+
+            static void __swap_alloc(Alloc&, Alloc&, std::false_type) {}
+
+            void __release()
+            {
+                if (this->__slots != nullptr)
+                {
+                    this->clear();
+                    alloc_traits::deallocate(this->__alloc, this->__slots, this->__capacity);
+                    this->__slots = nullptr;
+                }
+            }
+    };
+
+    template<typename T, typename Alloc>
+    const typename ring_buffer<T, Alloc>::size_type ring_buffer<T, Alloc>::default_capacity;
+
+    template<typename T, typename Alloc>
+    inline void swap(ring_buffer<T, Alloc>& lhs, ring_buffer<T, Alloc>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif // !__CONCURRENT_STORAGE_RING_BUFFER_HPP__
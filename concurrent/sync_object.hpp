@@ -1,13 +1,24 @@
 #ifndef __CONCURRENT_SYNC_OBJECT_HPP__ 
 #define __CONCURRENT_SYNC_OBJECT_HPP__
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstring>
 #include <exception>
 #include <functional>
+#include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 
 #include "error_handling/expected.hpp"
+#include "internal/waiter.hpp"
 #include "queue.hpp"
+#include "read_only.hpp"
+#include "wait_strategy.hpp"
 #include "util/detect.hpp"
 #include "util/member_swap.hpp"
 
@@ -20,13 +31,50 @@
 
 namespace concurrent
 {
+    namespace internal
+    {
+        /** \brief Holds a lock in shared mode for its lifetime, like std::shared_lock without the bookkeeping.
+         */
+        template<typename Lock>
+        class shared_guard
+        {
+            public:
+                explicit shared_guard(Lock& lock) : __lock(lock)
+                {
+                    this->__lock.lock_shared();
+                }
+
+                ~shared_guard()
+                {
+                    this->__lock.unlock_shared();
+                }
+
+            private:
+                // Prohibitions
+                shared_guard(const shared_guard& rhs);
+                shared_guard& operator=(const shared_guard& rhs);
+
+                Lock& __lock;
+        };
+
+        struct sync_object_access;
+    }
+
     /** \brief This is a synchronous monitor class. It handles a parameter of the particular type, granting concurrent-safe access by sending functor-messages synchronously.
      *         It is based upon the monitor<T> class presented by Herb Sutter.
      *         http://channel9.msdn.com/Shows/Going+Deep/C-and-Beyond-2012-Herb-Sutter-Concurrency-and-Parallelism
+     *         If the lock offers shared access (lock_shared() and unlock_shared(), like std::shared_mutex or
+     *         concurrent::reader_biased_lock), read-only functors - those taking a const T&, or wrapped by concurrent::read_only() -
+     *         are executed under a shared lock, thus concurrently with each other. All other functors get exclusive access.
      *
-     *  \param Data-type that should be covered by this class.
+     *         concurrent::sync_object<lookup_table, concurrent::reader_biased_lock> table;
+     *         auto hit = table <= [&](const lookup_table& t) { return t.find(key); };    // shared
+     *         table <= [&](lookup_table& t) { t.insert(key, value); };                  // exclusive
+     *
+     *  \param T Data-type that should be covered by this class.
+     *  \param Lock Lock type; std::mutex by default.
      */
-    template<typename T>
+    template<typename T, typename Lock = std::mutex>
     class sync_object
     {
         public:
@@ -49,8 +97,8 @@ namespace concurrent
                 static_assert( std::is_copy_constructible<T>::value, "T is not copy-constructible!" );
                 if (this != std::addressof(rhs))
                 {
-                    std::lock_guard<std::mutex> guard(rhs.__lock);
-                    std::lock_guard<std::mutex> guard2(this->__lock);
+                    std::lock_guard<Lock> guard(rhs.__lock);
+                    std::lock_guard<Lock> guard2(this->__lock);
                     // If T has a member-swap that takes another instance of T as a reference and returns void, it is considered to support the copy-and-swap-idiom.
                     // In this case, the call below will reach the function that uses this idiom to assign the rhs-T to the local one, otherwise, it will perform
                     // a simple assignment ( = ).
@@ -69,8 +117,8 @@ namespace concurrent
                 static_assert( std::is_move_constructible<T>::value, "T is not move-constructible!" );
                 if (this != std::addressof(rhs))
                 {
-                    std::lock_guard<std::mutex> guard(rhs.__lock);
-                    std::lock_guard<std::mutex> guard2(this->__lock);
+                    std::lock_guard<Lock> guard(rhs.__lock);
+                    std::lock_guard<Lock> guard2(this->__lock);
                     this->__myT = std::move(rhs.__myT);
                 }
             }
@@ -80,7 +128,7 @@ namespace concurrent
              */
             ~sync_object() 
             {
-                std::lock_guard<std::mutex> guard(this->__lock); 
+                std::lock_guard<Lock> guard(this->__lock); 
             }
 
             /** \brief Assignment operator
@@ -94,7 +142,7 @@ namespace concurrent
                 static_assert( std::is_copy_assignable<T>::value, "T is not copy-assignable!" );
                 if (this != std::addressof(rhs))
                 {
-                    std::lock_guard<std::mutex> guard(rhs.__lock); 
+                    std::lock_guard<Lock> guard(rhs.__lock); 
                     // If T has a member-swap that takes another instance of T as a reference and returns void, it is considered to support the copy-and-swap-idiom.
                     // In this case, the call below will reach the function that uses this idiom to assign the rhs-T to the local one, otherwise, it will perform
                     // a simple assignment ( = ).
@@ -114,7 +162,7 @@ namespace concurrent
                 static_assert( std::is_move_assignable<T>::value, "T is not move-assignable!" );
                 if (this != std::addressof(rhs))
                 {
-                    std::lock_guard<std::mutex> guard(rhs.__lock); 
+                    std::lock_guard<Lock> guard(rhs.__lock); 
                     this->__myT = std::move(rhs.__myT);
                 }                
                 return *this;
@@ -127,17 +175,461 @@ namespace concurrent
              * \note This function will block until the lock could be acquired.
              */
             template<typename F>
-            auto operator <= (F&& f) const -> expected::value<decltype(f(__myT))>
+            auto operator <= (F&& f) const -> expected::value<decltype(f(std::declval<T&>()))>
             {
-                std::lock_guard<std::mutex> guard(this->__lock);
-                auto res = expected::result_of([&]() { return f(__myT); } );
-                return res;                
+                return this->__apply(f, std::integral_constant<bool, is_read_only<F, T>::value && detect::has_member_lock_shared<Lock>::value>());
             }  
 
         private:
+            friend struct internal::sync_object_access;
+
             mutable T __myT;           /**< Value that should be modifiable through any executed functor */
-            mutable std::mutex __lock; /**< Internally synchronized lock */
+            mutable Lock __lock;       /**< Internally synchronized lock */
+
+            template<typename F>
+            auto __apply(F& f, std::false_type /* exclusive */) const -> expected::value<decltype(f(std::declval<T&>()))>
+            {
+                std::lock_guard<Lock> guard(this->__lock);
+                auto res = expected::result_of([&]() { return f(__myT); } );
+                return res;                
+            }
+
+            template<typename F>
+            auto __apply(F& f, std::true_type /* shared */) const -> expected::value<decltype(f(std::declval<T&>()))>
+            {
+                internal::shared_guard<Lock> guard(this->__lock);
+                const T& value = this->__myT;
+                auto res = expected::result_of([&]() { return f(value); } );
+                return res;
+            }
     };
+
+    /** \brief Selects the flat-combining version of sync_object, see sync_object<T, flat_combining>.
+     */
+    struct flat_combining {};
+
+    namespace internal
+    {
+        /** \brief Request published to a flat-combining sync_object: a functor waiting to be applied to the value. It lives
+         *         on the stack of the calling thread, which waits until "done" is set.
+         */
+        template<typename T>
+        struct combining_request
+        {
+            combining_request(void (*a)(combining_request*, T&)) : next(nullptr), apply(a), done(false) {}
+
+            combining_request* next;
+            void (*apply)(combining_request*, T&);
+            std::atomic<bool> done;
+        };
+
+        template<typename T, typename F, typename R>
+        struct typed_combining_request : combining_request<T>
+        {
+            typedef expected::value<R> result_type;
+
+            explicit typed_combining_request(F& func) : combining_request<T>(&typed_combining_request::__apply), f(func) {}
+
+            ~typed_combining_request()
+            {
+                if (this->done.load(std::memory_order_relaxed))
+                {
+                    reinterpret_cast<result_type*>(&this->result)->~result_type();
+                }
+            }
+
+            F& f;
+            typename std::aligned_storage<sizeof(result_type), alignof(result_type)>::type result;
+
+            static void __apply(combining_request<T>* request, T& value)
+            {
+                typed_combining_request* self = static_cast<typed_combining_request*>(request);
+                ::new (&self->result) result_type(expected::result_of([&]() { return self->f(value); }));
+            }
+        };
+    }
+
+    /** \brief Flat-combining version of sync_object, for values that many threads update with small functors at a high rate.
+     *         With a plain mutex, every functor costs a lock handoff between cores, and the value's cache lines travel along
+     *         with it. Here, callers publish their functor instead, and whichever of them gets to be the combiner applies
+     *         all published functors in one pass, while the value stays in its cache. The others wait for their results.
+     *         Functors are applied in the order they were published.
+     *
+     *         concurrent::sync_object<statistics, concurrent::flat_combining> stats;
+     *         stats <= [&](statistics& s) { s.add(sample); };
+     *
+     *  \param T Data-type that should be covered by this class.
+     *  \note The functors run on whichever thread combines, so they must not depend on the calling thread (e.g. thread-locals).
+     *  \note Under low contention, every caller simply combines its own functor; this costs about as much as a mutex.
+     */
+    template<typename T>
+    class sync_object<T, flat_combining>
+    {
+        public:
+            static const std::size_t max_combining_passes = 8;  /**< Passes over the published functors before a combiner hands over */
+
+            sync_object(T t = T{}) : __myT(t), __pending(nullptr), __combining(false)
+            {
+
+            }
+
+            /** \brief Copy c'tor. Copies the value of rhs with a functor, i.e. in order with the others sent to rhs.
+             */
+            sync_object(const sync_object& rhs) : __myT((rhs <= [](const T& value) -> T { return value; }).get()), __pending(nullptr), __combining(false)
+            {
+                static_assert( std::is_copy_constructible<T>::value, "T is not copy-constructible!" );
+            }
+
+            /** \brief Move c'tor. Moves the value out of rhs with a functor, i.e. in order with the others sent to rhs.
+             */
+            sync_object(sync_object&& rhs) : __myT((rhs <= [](T& value) -> T { return std::move(value); }).get()), __pending(nullptr), __combining(false)
+            {
+                static_assert( std::is_move_constructible<T>::value, "T is not move-constructible!" );
+            }
+
+            sync_object& operator=(const sync_object& rhs)
+            {
+                static_assert( std::is_copy_assignable<T>::value, "T is not copy-assignable!" );
+                if (this != std::addressof(rhs))
+                {
+                    T value = (rhs <= [](const T& value) -> T { return value; }).get();
+                    *this <= [&value](T& mine) -> void { mine = std::move(value); };
+                }
+                return *this;
+            }
+
+            sync_object& operator=(sync_object&& rhs)
+            {
+                static_assert( std::is_move_assignable<T>::value, "T is not move-assignable!" );
+                if (this != std::addressof(rhs))
+                {
+                    T value = (rhs <= [](T& value) -> T { return std::move(value); }).get();
+                    *this <= [&value](T& mine) -> void { mine = std::move(value); };
+                }
+                return *this;
+            }
+
+            /** \brief Sets how waiting callers wait for their results before they park.
+             *
+             * \param strategy const wait_strategy& Strategy to use.
+             * \note Has to be set before the object is shared between threads.
+             */
+            void set_wait_strategy(const wait_strategy& strategy)
+            {
+                this->__completed.set_strategy(strategy);
+            }
+
+            /** \brief Publishes a functor and waits until it was applied to the value, possibly by the calling thread itself.
+             *
+             * \param f F Functor to execute.
+             * \return Anything that the functor returns.
+             * \note This function will block until the functor was applied.
+             */
+            template<typename F>
+            auto operator <= (F&& f) const -> expected::value<decltype(f(std::declval<T&>()))>
+            {
+                typedef decltype(f(std::declval<T&>())) result_type;
+                internal::typed_combining_request<T, typename std::remove_reference<F>::type, result_type> request(f);
+                this->__publish(&request);
+                bool combiner = false;
+                this->__completed.wait([&]() -> bool {
+                    return request.done.load(std::memory_order_acquire) || (combiner = this->__try_become_combiner());
+                });
+                if (combiner)
+                {
+                    this->__combine();
+                }
+                return std::move(*reinterpret_cast<expected::value<result_type>*>(&request.result));
+            }
+
+        private:
+            typedef internal::combining_request<T> request_type;
+
+            mutable T __myT;                                    /**< Only touched by the combiner */
+            mutable std::atomic<request_type*> __pending;       /**< Published requests, latest first */
+            mutable std::atomic<bool> __combining;              /**< Whether there is a combiner */
+            mutable internal::waiter __completed;               /**< Callers waiting for their requests or the combiner's role */
+
+            void __publish(request_type* request) const
+            {
+                request_type* head = this->__pending.load(std::memory_order_relaxed);
+                do
+                {
+                    request->next = head;
+                }
+                while (!this->__pending.compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            bool __try_become_combiner() const
+            {
+                return !this->__combining.load(std::memory_order_relaxed) && !this->__combining.exchange(true, std::memory_order_acquire);
+            }
+
+            /** \brief Applies published requests until there are none left or the maximum number of passes is reached. The
+             *         combiner's own request is among them, since it was published first. Whoever is left waiting afterwards
+             *         gets to be the next combiner.
+             */
+            void __combine() const
+            {
+                for (std::size_t pass = 0; pass < max_combining_passes; ++pass)
+                {
+                    request_type* requests = this->__pending.exchange(nullptr, std::memory_order_acquire);
+                    if (requests == nullptr)
+                    {
+                        break;
+                    }
+                    request_type* ordered = nullptr; // Oldest first
+                    while (requests != nullptr)
+                    {
+                        request_type* next = requests->next;
+                        requests->next = ordered;
+                        ordered = requests;
+                        requests = next;
+                    }
+                    while (ordered != nullptr)
+                    {
+                        request_type* next = ordered->next; // The request may be gone as soon as it is done.
+                        ordered->apply(ordered, this->__myT);
+                        ordered->done.store(true, std::memory_order_release);
+                        ordered = next;
+                    }
+                }
+                this->__combining.store(false, std::memory_order_release);
+                this->__completed.notify_all();
+            }
+    };
+
+    /** \brief Selects the sequence-lock version of sync_object, see sync_object<T, seqlock>.
+     */
+    struct seqlock {};
+
+    /** \brief Sequence-lock version of sync_object, for small trivially copyable values that are read far more often than
+     *         written, like counters, configuration structs or price ticks. Read-only functors (taking a const T&, or
+     *         wrapped by concurrent::read_only() ) do not lock at all: they copy the value, check that no writer interfered
+     *         and retry otherwise, then run on the copy. Readers thus never write to a shared cache line, so they do not
+     *         slow each other down the way they do on a mutex or a shared reader count.
+     *         All other functors are writers; they are serialized by a mutex and bump a sequence number around their update.
+     *
+     *         concurrent::sync_object<tick, concurrent::seqlock> last;
+     *         last <= [&](tick& t) { t = incoming; };                          // writer
+     *         double price = (last <= [](const tick& t) { return t.price; }).get();  // reader, lock-free
+     *
+     *  \param T Data-type that should be covered by this class; has to be trivially copyable, but not default-constructible.
+     *  \note Read-only functors run on a private copy, so references into the value they return refer to that copy and must
+     *        not be kept. Writers make readers retry; under constant writes, readers may retry for a while.
+     */
+    template<typename T>
+    class sync_object<T, seqlock>
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "T is not trivially copyable!" );
+
+        public:
+            /** \brief Default c'tor; only available if T is default-constructible.
+             */
+            sync_object() : __sequence(0)
+            {
+                this->__store(T{});
+            }
+
+            sync_object(const T& t) : __sequence(0)
+            {
+                this->__store(t);
+            }
+
+            sync_object(const sync_object& rhs) : __sequence(0)
+            {
+                this->__store(rhs.__snapshot());
+            }
+
+            sync_object& operator=(const sync_object& rhs)
+            {
+                if (this != std::addressof(rhs))
+                {
+                    T value = rhs.__snapshot();
+                    *this <= [&value](T& mine) -> void { mine = value; };
+                }
+                return *this;
+            }
+
+            /** \brief Executes a functor on the value: a read-only functor on a consistent copy without locking, any other one
+             *         under the writers' lock.
+             *
+             * \param f F Functor to execute.
+             * \return Anything that the functor returns.
+             * \note Writers block until the lock could be acquired; readers only retry while a writer is active.
+             */
+            template<typename F>
+            auto operator <= (F&& f) const -> expected::value<decltype(f(std::declval<T&>()))>
+            {
+                return this->__apply(f, std::integral_constant<bool, is_read_only<F, T>::value>());
+            }
+
+        private:
+            typedef std::size_t word;
+
+            static const std::size_t num_words = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+            mutable std::atomic<std::size_t> __sequence;        /**< Odd while a writer updates the value */
+            mutable std::atomic<word> __words[num_words];       /**< The value; accessed word by word, so a torn read is no data race */
+            mutable std::mutex __writerLock;                    /**< Serializes writers */
+
+            template<typename F>
+            auto __apply(F& f, std::false_type /* writer */) const -> expected::value<decltype(f(std::declval<T&>()))>
+            {
+                std::lock_guard<std::mutex> guard(this->__writerLock);
+                T value = this->__load();
+                auto res = expected::result_of([&]() { return f(value); } );
+                std::size_t sequence = this->__sequence.load(std::memory_order_relaxed);
+                this->__sequence.store(sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                this->__store(value);
+                this->__sequence.store(sequence + 2, std::memory_order_release);
+                return res;
+            }
+
+            template<typename F>
+            auto __apply(F& f, std::true_type /* reader */) const -> expected::value<decltype(f(std::declval<T&>()))>
+            {
+                const T value = this->__snapshot();
+                return expected::result_of([&]() { return f(value); } );
+            }
+
+            /** \brief Copies the value, retrying until no writer was active during the copy.
+             */
+            T __snapshot() const
+            {
+                for (std::size_t attempt = 0; ; ++attempt)
+                {
+                    std::size_t before = this->__sequence.load(std::memory_order_acquire);
+                    if ((before & 1) == 0)
+                    {
+                        T value = this->__load();
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (this->__sequence.load(std::memory_order_relaxed) == before)
+                        {
+                            return value;
+                        }
+                    }
+                    if (attempt % 64 == 63)
+                    {
+                        std::this_thread::yield();  // The writer may be preempted.
+                    }
+                }
+            }
+
+            T __load() const
+            {
+                // Aligned for T, so the copy can be read as one without requiring T to be default-constructible.
+                typename std::aligned_storage<num_words * sizeof(word), (alignof(T) > alignof(word) ? alignof(T) : alignof(word))>::type buffer;
+                for (std::size_t i = 0; i < num_words; ++i)
+                {
+                    word w = this->__words[i].load(std::memory_order_relaxed);
+                    std::memcpy(reinterpret_cast<char*>(&buffer) + i * sizeof(word), &w, sizeof(word));
+                }
+                return *reinterpret_cast<const T*>(&buffer);
+            }
+
+            void __store(const T& value) const
+            {
+                word buffer[num_words] = {};
+                std::memcpy(buffer, static_cast<const void*>(&value), sizeof(T));
+                for (std::size_t i = 0; i < num_words; ++i)
+                {
+                    this->__words[i].store(buffer[i], std::memory_order_relaxed);
+                }
+            }
+    };
+
+    namespace internal
+    {
+        /** \brief Access to the lock and value of sync_objects, for sync_apply().
+         */
+        struct sync_object_access
+        {
+            /** \brief Lock of a sync_object, with its type erased so that the locks of differently typed objects can be sorted.
+             */
+            struct erased_lock
+            {
+                void* lock;
+                void (*acquire)(void*);
+                void (*release)(void*);
+
+                bool operator<(const erased_lock& rhs) const
+                {
+                    return std::less<void*>()(this->lock, rhs.lock);
+                }
+            };
+
+            template<typename T, typename Lock>
+            static erased_lock lock_of(const sync_object<T, Lock>& obj)
+            {
+                return erased_lock{ static_cast<void*>(std::addressof(obj.__lock)),
+                                    [](void* lock) -> void { static_cast<Lock*>(lock)->lock(); },
+                                    [](void* lock) -> void { static_cast<Lock*>(lock)->unlock(); } };
+            }
+
+            template<typename T, typename Lock>
+            static T& value_of(const sync_object<T, Lock>& obj)
+            {
+                return obj.__myT;
+            }
+        };
+
+        /** \brief Releases the first "count" of the given locks on destruction, in reverse order.
+         */
+        template<std::size_t N>
+        struct ordered_locks
+        {
+            std::array<sync_object_access::erased_lock, N> locks;
+            std::size_t count;
+
+            ordered_locks() : count(0) {}
+
+            ~ordered_locks()
+            {
+                while (this->count > 0)
+                {
+                    const auto& l = this->locks[--this->count];
+                    l.release(l.lock);
+                }
+            }
+        };
+    }
+
+    /** \brief Executes a functor atomically on the values of several sync_objects, e.g. to move money between two accounts:
+     *
+     *         concurrent::sync_object<account> from, to;
+     *         auto moved = concurrent::sync_apply([&](account& a, account& b) { a.withdraw(amount); b.deposit(amount); }, from, to);
+     *
+     *         All locks are acquired in the order of their addresses, whatever the order of the arguments, thus concurrent
+     *         calls of sync_apply() on overlapping objects cannot deadlock - unlike nested operator<= calls, which do as soon
+     *         as two threads nest them the other way round. An object given more than once is locked once, and the functor
+     *         gets the same value for each of its occurrences.
+     *
+     * \param f F Functor to execute; it gets the values of all objects (as T&), in the order of the arguments.
+     * \param objects const sync_object<T, Lock>&... Objects to lock; the lock types may differ.
+     * \return Anything that the functor returns, or the exception it threw.
+     * \note Blocks until all locks could be acquired. All of them are taken exclusively. Only for lock-based sync_objects.
+     */
+    template<typename F, typename... Ts, typename... Locks>
+    auto sync_apply(F&& f, const sync_object<Ts, Locks>&... objects) -> expected::value<decltype(f(std::declval<Ts&>()...))>
+    {
+        static_assert( sizeof...(Ts) > 0, "No sync_object to apply the functor to!" );
+        internal::ordered_locks<sizeof...(Ts)> held;
+        std::array<internal::sync_object_access::erased_lock, sizeof...(Ts)> wanted = {{ internal::sync_object_access::lock_of(objects)... }};
+        std::sort(wanted.begin(), wanted.end());
+        for (std::size_t i = 0; i < wanted.size(); ++i)
+        {
+            if (i > 0 && wanted[i].lock == wanted[i - 1].lock)
+            {
+                continue;
+            }
+            wanted[i].acquire(wanted[i].lock);
+            held.locks[held.count++] = wanted[i];
+        }
+        auto res = expected::result_of([&]() { return f(internal::sync_object_access::value_of(objects)...); } );
+        return res;
+    }
 }
 
 #endif  // !__CONCURRENT_SYNC_OBJECT_HPP__
\ No newline at end of file
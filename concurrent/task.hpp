@@ -0,0 +1,204 @@
+#ifndef __CONCURRENT_TASK_HPP__
+#define __CONCURRENT_TASK_HPP__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent/internal/block_pool.hpp"
+
+namespace concurrent
+{
+    /** \brief Move-only replacement for std::function<void()>, used for the work queues of async_object and executor.
+     *         Functors of up to inline_size bytes are stored inside the task itself; larger ones are put into memory from
+     *         internal::block_pool. Thus, creating, moving and running a task does not hit the heap in steady state -
+     *         unlike std::function, which allocates for nearly every lambda that captures more than two pointers.
+     *         Being move-only, it can also carry move-only state like a std::promise.
+     *
+     *  \note Over-aligned functors are not supported.
+     */
+    class task
+    {
+        public:
+            static const std::size_t inline_size = 112;     /**< Largest functor stored inline, in bytes; sizeof(task) is 128 */
+
+            task() : __ops(nullptr) {}
+
+            task(std::nullptr_t) : __ops(nullptr) {}
+
+            /** \brief C'tor. Takes over the given functor.
+             *
+             * \param f F&& Functor to call, taking no arguments. Its result, if any, is discarded.
+             */
+            template<typename F, typename = typename std::enable_if< !std::is_same<typename std::decay<F>::type, task>::value >::type>
+            task(F&& f) : __ops(nullptr)
+            {
+                typedef typename std::decay<F>::type functor_type;
+                static_assert( alignof(functor_type) <= alignof(std::max_align_t), "Over-aligned functors are not supported!" );
+                __construct<functor_type>(std::forward<F>(f), std::integral_constant<bool, __fits_inline<functor_type>::value>());
+            }
+
+            task(task&& rhs) : __ops(rhs.__ops)
+            {
+                if (this->__ops != nullptr)
+                {
+                    this->__ops->move(rhs.__storage, this->__storage);
+                    rhs.__ops = nullptr;
+                }
+            }
+
+            task& operator=(task&& rhs)
+            {
+                if (this != &rhs)
+                {
+                    this->__reset();
+                    if (rhs.__ops != nullptr)
+                    {
+                        rhs.__ops->move(rhs.__storage, this->__storage);
+                        this->__ops = rhs.__ops;
+                        rhs.__ops = nullptr;
+                    }
+                }
+                return *this;
+            }
+
+            task& operator=(std::nullptr_t)
+            {
+                this->__reset();
+                return *this;
+            }
+
+            ~task()
+            {
+                this->__reset();
+            }
+
+            /** \brief Runs the functor. The task must not be empty.
+             */
+            void operator()()
+            {
+                this->__ops->invoke(this->__storage);
+            }
+
+            explicit operator bool() const
+            {
+                return this->__ops != nullptr;
+            }
+
+        private:
+            // Prohibitions
+            task(const task& rhs);
+            task& operator=(const task& rhs);
+
+            /** \brief Type-erased operations on the stored functor.
+             */
+            struct ops
+            {
+                void (*invoke)(void* storage);
+                void (*move)(void* from, void* to);         /**< Moves from one storage to another and destroys the source */
+                void (*destroy)(void* storage);
+            };
+
+            template<typename F>
+            struct __fits_inline : std::integral_constant<bool, sizeof(F) <= inline_size && std::is_nothrow_move_constructible<F>::value> {};
+
+            /** \brief Functor stored inside the task.
+             */
+            template<typename F>
+            struct inline_ops
+            {
+                static void invoke(void* storage)
+                {
+                    (*static_cast<F*>(storage))();
+                }
+
+                static void move(void* from, void* to)
+                {
+                    F* source = static_cast<F*>(from);
+                    ::new (to) F(std::move(*source));
+                    source->~F();
+                }
+
+                static void destroy(void* storage)
+                {
+                    static_cast<F*>(storage)->~F();
+                }
+
+                static const ops table;
+            };
+
+            /** \brief Functor stored in pooled memory; the task only keeps a pointer to it.
+             */
+            template<typename F>
+            struct pooled_ops
+            {
+                static F*& target(void* storage)
+                {
+                    return *static_cast<F**>(storage);
+                }
+
+                static void invoke(void* storage)
+                {
+                    (*target(storage))();
+                }
+
+                static void move(void* from, void* to)
+                {
+                    ::new (to) F*(target(from));
+                }
+
+                static void destroy(void* storage)
+                {
+                    F* f = target(storage);
+                    f->~F();
+                    internal::pool_deallocate(f, sizeof(F));
+                }
+
+                static const ops table;
+            };
+
+            alignas(std::max_align_t) unsigned char __storage[inline_size];
+            const ops* __ops;
+
+            template<typename F, typename Arg>
+            void __construct(Arg&& f, std::true_type /* inline */)
+            {
+                ::new (static_cast<void*>(this->__storage)) F(std::forward<Arg>(f));
+                this->__ops = &inline_ops<F>::table;
+            }
+
+            template<typename F, typename Arg>
+            void __construct(Arg&& f, std::false_type /* pooled */)
+            {
+                void* memory = internal::pool_allocate(sizeof(F));
+                try
+                {
+                    ::new (static_cast<void*>(this->__storage)) F*(::new (memory) F(std::forward<Arg>(f)));
+                }
+                catch (...)
+                {
+                    internal::pool_deallocate(memory, sizeof(F));
+                    throw;
+                }
+                this->__ops = &pooled_ops<F>::table;
+            }
+
+            void __reset()
+            {
+                if (this->__ops != nullptr)
+                {
+                    this->__ops->destroy(this->__storage);
+                    this->__ops = nullptr;
+                }
+            }
+    };
+
+    template<typename F>
+    const task::ops task::inline_ops<F>::table = { &task::inline_ops<F>::invoke, &task::inline_ops<F>::move, &task::inline_ops<F>::destroy };
+
+    template<typename F>
+    const task::ops task::pooled_ops<F>::table = { &task::pooled_ops<F>::invoke, &task::pooled_ops<F>::move, &task::pooled_ops<F>::destroy };
+}
+
+#endif // !__CONCURRENT_TASK_HPP__
@@ -0,0 +1,105 @@
+#ifndef __CONCURRENT_WAIT_STRATEGY_HPP__
+#define __CONCURRENT_WAIT_STRATEGY_HPP__
+
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+
+namespace concurrent
+{
+    namespace internal
+    {
+        /** \brief Hints the CPU that the calling thread is busy-waiting, which saves power and frees resources for a
+         *         sibling hyper-thread. Compiles to nothing on platforms without such an instruction.
+         */
+        inline void cpu_relax()
+        {
+        #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+            _mm_pause();
+        #elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+            __builtin_ia32_pause();
+        #elif defined(__GNUC__) && defined(__aarch64__)
+            __asm__ __volatile__("yield");
+        #endif
+        }
+
+        /** \brief Busy-waiting only pays off if the awaited thread can run at the same time.
+         */
+        inline bool can_spin()
+        {
+            static const bool multiCore = std::thread::hardware_concurrency() != 1;
+            return multiCore;
+        }
+    }
+
+    /** \brief Describes how a thread waits for a queue or channel before it gets parked by the OS: it first spins for
+     *         spin_count rounds, then gives up its time slice up to yield_count times, and only then goes to sleep.
+     *         Spinning avoids the syscall and context switch of a sleep/wakeup pair if the partner thread reacts within
+     *         a few microseconds, at the cost of burning CPU time while doing so.
+     *
+     *         concurrent::channel<int> ch;
+     *         ch.set_wait_strategy(concurrent::wait_strategy::latency_optimized());
+     *
+     *  \note The strategy should be set before an instance is shared between threads.
+     */
+    struct wait_strategy
+    {
+        unsigned spin_count;    /**< Busy rounds before yielding */
+        unsigned yield_count;   /**< Rounds with std::this_thread::yield() before parking */
+
+        wait_strategy(unsigned spins, unsigned yields) : spin_count(spins), yield_count(yields) {}
+
+        /** \brief Spins long and yields often; for threads that own a core and have to react as fast as possible.
+         */
+        static wait_strategy latency_optimized()
+        {
+            return wait_strategy(16384, 256);
+        }
+
+        /** \brief Short spin and a few yields; covers quick handoffs without wasting much CPU time. Used by default.
+         */
+        static wait_strategy balanced()
+        {
+            return wait_strategy(128, 8);
+        }
+
+        /** \brief Parks immediately; for oversubscribed machines and rarely used queues.
+         */
+        static wait_strategy cpu_friendly()
+        {
+            return wait_strategy(0, 0);
+        }
+
+        /** \brief Runs the spin and yield phases until ready() returns true. The spin phase is skipped on single-core machines.
+         *
+         * \param ready Pred Cheap check whether waiting is over. Called once per round.
+         * \return bool "true" if ready() succeeded, "false" if the caller should park now.
+         */
+        template<typename Pred>
+        bool spin(Pred ready) const
+        {
+            unsigned spins = internal::can_spin() ? this->spin_count : 0;
+            for (unsigned round = 0; round < spins; ++round)
+            {
+                if (ready())
+                {
+                    return true;
+                }
+                internal::cpu_relax();
+            }
+            for (unsigned round = 0; round < this->yield_count; ++round)
+            {
+                if (ready())
+                {
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+            return false;
+        }
+    };
+}
+
+#endif // !__CONCURRENT_WAIT_STRATEGY_HPP__
@@ -0,0 +1,19 @@
+#ifndef __TEST_ALLOCATION_COUNTER_HPP__
+#define __TEST_ALLOCATION_COUNTER_HPP__
+
+#include <atomic>
+#include <cstdint>
+
+namespace conc_test
+{
+    /** \brief Number of heap allocations performed by the process so far. Main.cpp replaces the global operator new to
+     *         count them.
+     */
+    inline std::atomic<std::uint64_t>& allocation_counter()
+    {
+        static std::atomic<std::uint64_t> counter(0);
+        return counter;
+    }
+}
+
+#endif // __TEST_ALLOCATION_COUNTER_HPP__
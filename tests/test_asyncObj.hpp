@@ -2,9 +2,23 @@
 #define __TEST_ASYNC_OBJ_HPP__
 
 #include "concurrent/async_object.hpp"
+#include "concurrent/executor.hpp"
+#include "concurrent/future.hpp"
+#include "concurrent/task.hpp"
+#include "tests/allocation_counter.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <future>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace conc_test
 {
@@ -130,6 +144,459 @@ namespace conc_test
             std::cout << res3.get() << std::endl;
         }
 
+        void test_executor()
+        {
+            const std::size_t numObjects = 10000;
+            const int numCalls = 10;
+            concurrent::executor pool(4);
+            std::vector<std::unique_ptr<concurrent::async_object<std::vector<int>>>> objects;
+            objects.reserve(numObjects);
+            for (std::size_t i = 0; i < numObjects; ++i)
+            {
+                objects.emplace_back(new concurrent::async_object<std::vector<int>>(pool));
+            }
+            for (int call = 0; call < numCalls; ++call)
+            {
+                for (auto& obj : objects)
+                {
+                    *obj <= ( [call](std::vector<int>& v) -> void { v.push_back(call); });
+                }
+            }
+            std::vector<concurrent::future<bool>> inOrder;
+            inOrder.reserve(numObjects);
+            for (auto& obj : objects)
+            {
+                inOrder.push_back(*obj <= ( [numCalls](std::vector<int>& v) -> bool {
+                    bool ordered = v.size() == static_cast<std::size_t>(numCalls);
+                    for (std::size_t i = 0; ordered && i < v.size(); ++i)
+                    {
+                        ordered = v[i] == static_cast<int>(i);
+                    }
+                    return ordered;
+                }));
+            }
+            bool allInOrder = true;
+            for (auto& res : inOrder)
+            {
+                allInOrder = res.get() && allInOrder;
+            }
+            std::cout << numObjects << " objects on " << pool.size() << " threads, all calls in order: " << std::boolalpha << allInOrder << std::endl;
+
+            concurrent::async_object<std::string> blub (pool, "Hello World!");
+            concurrent::async_object<std::string> blub2 (blub);
+            concurrent::async_object<std::string> blub3 (pool, "Hello Ape!");
+            blub3 = std::move(blub2);
+            auto res = blub3 <= ( [](std::string& s) -> std::string { return s; });
+            std::cout << "Copied and moved on executor: " << res.get() << std::endl;
+
+            concurrent::executor single(1);
+            std::unique_ptr<concurrent::async_object<int>> inner(new concurrent::async_object<int>(single, 41));
+            int seen = 0;
+            std::promise<int> destroyed;
+            single.submit([&]() -> void {
+                *inner <= ( [&seen](int& i) -> void { seen = ++i; });
+                inner.reset(); // Has to run the increment itself, since the only worker is busy with this task.
+                destroyed.set_value(seen);
+            });
+            std::cout << "Destroyed on its own single-threaded executor, value: " << destroyed.get_future().get() << std::endl;
+        }
+
+        /** \brief Sends numCalls functors that capture a few values, waits for each result and returns the number of heap
+         *         allocations that happened meanwhile.
+         */
+        std::uint64_t count_allocations(concurrent::async_object<std::int64_t>& obj, int numCalls)
+        {
+            std::int64_t a = 1, b = 2, c = 3;
+            std::uint64_t before = allocation_counter().load();
+            for (int i = 0; i < numCalls; ++i)
+            {
+                auto res = obj <= ( [a, b, c, i](std::int64_t& value) -> std::int64_t { return value += a + b + c + i; });
+                res.get();
+            }
+            return allocation_counter().load() - before;
+        }
+
+        void test_allocations()
+        {
+            concurrent::async_object<std::int64_t> threaded;
+            count_allocations(threaded, 1000); // Warm up the pools.
+            std::cout << "Allocations for 10000 calls on own thread: " << count_allocations(threaded, 10000) << std::endl;
+
+            concurrent::executor pool(2);
+            concurrent::async_object<std::int64_t> stranded(pool);
+            count_allocations(stranded, 1000);
+            std::cout << "Allocations for 10000 calls on executor: " << count_allocations(stranded, 10000) << std::endl;
+
+            std::array<std::int64_t, 32> big;
+            big.fill(1);
+            std::int64_t sum = 0;
+            concurrent::task warmUp([big, &sum]() -> void { sum += big[0]; });
+            warmUp();
+            std::uint64_t before = allocation_counter().load();
+            for (int i = 0; i < 1000; ++i)
+            {
+                concurrent::task t([big, &sum]() -> void { sum += big[0]; }); // Too large for the inline buffer.
+                concurrent::task moved(std::move(t));
+                moved();
+            }
+            std::cout << "Allocations for 1000 pooled tasks: " << allocation_counter().load() - before << ", sum: " << sum << std::endl;
+        }
+
+        void test_future()
+        {
+            concurrent::promise<int> p;
+            concurrent::future<int> f = p.get_future();
+            bool timedOut = f.wait_for(std::chrono::milliseconds(10)) == std::future_status::timeout;
+            std::thread producer([&p]() -> void {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                p.set_value(42);
+            });
+            std::cout << "Timed out before: " << std::boolalpha << timedOut << ", ready before: " << f.is_ready()
+                      << ", value: " << f.get() << ", valid after get: " << f.valid() << std::endl;
+            producer.join();
+
+            concurrent::promise<std::string> failing;
+            concurrent::future<std::string> failed = failing.get_future();
+            failing.set_exception(std::make_exception_ptr(std::runtime_error("failed")));
+            try
+            {
+                failed.get();
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cout << "Exception passed: " << e.what() << std::endl;
+            }
+
+            concurrent::future<void> broken;
+            {
+                concurrent::promise<void> abandoned;
+                broken = abandoned.get_future();
+            }
+            try
+            {
+                broken.get();
+            }
+            catch (const std::future_error& e)
+            {
+                std::cout << "Broken promise: " << (e.code() == std::future_errc::broken_promise) << std::endl;
+            }
+
+            concurrent::async_object<std::string> blub ("Hello World!");
+            std::future<std::size_t> length = blub <= ( [](std::string& s) -> std::size_t { return s.size(); });
+            concurrent::future<std::string> copy = blub <= ( [](std::string& s) -> std::string { return s; });
+            std::future<std::string> converted = std::move(copy);
+            std::cout << "Converted to std::future: " << length.get() << " " << converted.get() << std::endl;
+        }
+
+        /** \brief Holds the object's worker back until a burst of calls is queued, then lets it run them.
+         */
+        void run_burst(concurrent::async_object<int>& obj, std::size_t maxBatchSize, const char* name)
+        {
+            obj.set_max_batch_size(maxBatchSize);
+            concurrent::promise<void> gate;
+            concurrent::future<void> opened = gate.get_future();
+            obj <= ( [&opened](int&) -> void { opened.wait(); });
+            for (int i = 0; i < 256; ++i)
+            {
+                obj <= ( [](int& value) -> void { ++value; });
+            }
+            gate.set_value();
+            int value = (obj <= ( [](int& value) -> int { return value; })).get();
+            concurrent::batch_statistics stats = obj.get_batch_statistics();
+            std::cout << name << ", max batch size " << obj.get_max_batch_size() << ": value " << value << ", largest batch " << stats.largest
+                      << ", batches of 64-127 calls: " << stats.sizes[6] << std::endl;
+        }
+
+        void test_batches()
+        {
+            concurrent::async_object<int> threaded;
+            run_burst(threaded, 64, "Own thread");
+            concurrent::async_object<int> threadedSmall;
+            run_burst(threadedSmall, 16, "Own thread");
+
+            concurrent::executor pool(1);
+            concurrent::async_object<int> stranded(pool);
+            run_burst(stranded, 64, "Executor");
+            concurrent::async_object<int> strandedSmall(pool);
+            run_burst(strandedSmall, 16, "Executor");
+        }
+
+        void test_post()
+        {
+            concurrent::async_object<std::string> blub ("Hello");
+            std::string lastError;
+            blub.set_error_handler([&lastError](std::exception_ptr e) -> void {
+                try
+                {
+                    std::rethrow_exception(e);
+                }
+                catch (const std::exception& ex)
+                {
+                    lastError = ex.what();
+                }
+            });
+            blub.post([](std::string& s) -> void { s += " World!"; });
+            blub.post([](std::string& s) -> void { throw std::runtime_error("Cannot append to \"" + s + "\""); });
+            auto res = blub <= ( [](std::string& s) -> std::string { return s; });
+            std::cout << "Value: " << res.get() << ", error: " << lastError << std::endl;
+
+            concurrent::async_object<int> overtaking;
+            std::atomic<int> reported(0);
+            overtaking.set_error_handler([&reported](std::exception_ptr) -> void { ++reported; });
+            overtaking.post(concurrent::priority::urgent, [](int&) -> void { throw std::runtime_error("urgent"); });
+            overtaking.call(concurrent::priority::urgent, [](int&) -> void {}).get();
+            std::cout << "Errors of urgent functors reported: " << reported.load() << std::endl;
+
+            concurrent::async_object<std::int64_t> counter;
+            std::uint64_t allocations = 0;
+            for (int round = 0; round < 2; ++round) // The first round lets the queue and the pools grow to the burst size.
+            {
+                std::uint64_t before = allocation_counter().load();
+                for (int i = 0; i < 10000; ++i)
+                {
+                    counter.post([](std::int64_t& value) -> void { ++value; });
+                }
+                (counter <= ( [](std::int64_t&) -> void {})).get();
+                allocations = allocation_counter().load() - before;
+            }
+            std::int64_t value = (counter <= ( [](std::int64_t& value) -> std::int64_t { return value; })).get();
+            std::cout << "Posted 2x10000 increments, value: " << value << ", allocations in 2nd round: " << allocations << std::endl;
+        }
+
+        void test_continuations()
+        {
+            concurrent::executor pool(2);
+            concurrent::async_object<std::string> source ("Hello");
+            concurrent::async_object<std::vector<std::size_t>> lengths (pool);
+            concurrent::future<std::size_t> chained = (source <= ( [](std::string& s) -> std::string { return s + " World!"; }))
+                .then(pool, [](std::string s) -> std::size_t { return s.size(); })
+                .then(lengths, [](std::vector<std::size_t>& v, std::size_t length) -> std::size_t { v.push_back(length); return v.size(); });
+            std::size_t stored = chained.get();
+            std::size_t length = (lengths <= ( [](std::vector<std::size_t>& v) -> std::size_t { return v.back(); })).get();
+            std::cout << "Chained: " << stored << " length(s) stored, last: " << length << std::endl;
+
+            concurrent::future<int> unwrapped = (source <= ( [](std::string& s) -> std::size_t { return s.size(); }))
+                .then([&lengths](std::size_t size) -> concurrent::future<int> {
+                    return lengths <= ( [size](std::vector<std::size_t>& v) -> int { return static_cast<int>(v.front() + size); });
+                });
+            std::cout << "Unwrapped nested future: " << unwrapped.get() << std::endl;
+
+            concurrent::future<int> skipped = (source <= ( [](std::string&) -> int { throw std::runtime_error("failed"); }))
+                .then([](int value) -> int { return value + 1; });
+            try
+            {
+                skipped.get();
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << "Exception passed along the chain: " << e.what() << std::endl;
+            }
+
+            std::vector<std::unique_ptr<concurrent::async_object<int>>> objects;
+            std::vector<concurrent::future<int>> squares;
+            for (int i = 0; i < 100; ++i)
+            {
+                objects.emplace_back(new concurrent::async_object<int>(pool, i));
+                squares.push_back(*objects.back() <= ( [](int& value) -> int { return value * value; }));
+            }
+            int sum = concurrent::when_all(squares).then([](std::vector<concurrent::future<int>> results) -> int {
+                int total = 0;
+                for (auto& f : results)
+                {
+                    total += f.get();
+                }
+                return total;
+            }).get();
+            std::cout << "Sum of 100 squares, from when_all: " << sum << std::endl;
+
+            concurrent::promise<int> never;
+            std::vector<concurrent::future<int>> candidates;
+            candidates.push_back(never.get_future());
+            candidates.push_back(*objects[7] <= ( [](int& value) -> int { return value; }));
+            concurrent::when_any_result<std::vector<concurrent::future<int>>> first = concurrent::when_any(candidates).get();
+            std::cout << "when_any: index " << first.index << ", value " << first.futures[first.index].get()
+                      << ", other ready: " << std::boolalpha << first.futures[0].is_ready() << std::endl;
+            never.set_value(0);
+            std::cout << "Forwarded later: " << first.futures[0].get() << std::endl;
+        }
+
+#ifdef CONCURRENT_HAS_COROUTINES
+        concurrent::future<std::size_t> total_length(concurrent::async_object<std::string>& first, concurrent::async_object<std::string>& second)
+        {
+            // Futures are created ahead of co_await, so the functors are not part of the coroutine frame.
+            concurrent::future<std::string> copied = first <= ( [](std::string& s) -> std::string { return s; });
+            std::string value = co_await copied;
+            concurrent::future<std::size_t> measured = second <= ( [](std::string& s) -> std::size_t { return s.size(); });
+            std::size_t length = co_await measured;
+            co_return value.size() + length;
+        }
+
+        concurrent::future<bool> resumed_on_executor(concurrent::executor& pool, concurrent::async_object<std::string>& obj)
+        {
+            concurrent::future<void> slept = obj <= ( [](std::string&) -> void { std::this_thread::sleep_for(std::chrono::milliseconds(10)); });
+            co_await slept;
+            co_return pool.in_worker_thread();
+        }
+
+        concurrent::future<void> rethrow(concurrent::async_object<std::string>& obj)
+        {
+            concurrent::future<int> failed = obj <= ( [](std::string&) -> int { throw std::runtime_error("failed"); });
+            try
+            {
+                co_await failed;
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cout << "Exception from co_await: " << e.what() << std::endl;
+            }
+        }
+#endif
+
+        void test_coroutines()
+        {
+#ifdef CONCURRENT_HAS_COROUTINES
+            concurrent::executor pool(2);
+            concurrent::async_object<std::string> hello ("Hello");
+            concurrent::async_object<std::string> world (pool, " World!");
+            std::cout << "Total length: " << total_length(hello, world).get() << std::endl;
+
+            concurrent::promise<concurrent::future<bool>> started;
+            concurrent::future<concurrent::future<bool>> coroutine = started.get_future();
+            pool.submit([&]() -> void { started.set_value(resumed_on_executor(pool, hello)); });
+            std::cout << "Resumed on the executor: " << std::boolalpha << coroutine.get().get() << std::endl;
+
+            rethrow(world).get();
+#else
+            std::cout << "No coroutine support." << std::endl;
+#endif
+        }
+
+        /** \brief Blocks the object's worker until the gate is opened; returns once it is blocked.
+         */
+        void block_worker(concurrent::async_object<int>& obj, concurrent::future<void>& opened)
+        {
+            concurrent::promise<void> entered;
+            concurrent::future<void> running = entered.get_future();
+            obj <= ( [&entered, &opened](int&) -> void { entered.set_value(); opened.wait(); });
+            running.wait();
+        }
+
+        /** \brief Holds the object's worker back until a backlog of bulk calls is queued, then sends an urgent call.
+         */
+        void run_backlog(concurrent::async_object<int>& obj, const char* name)
+        {
+            concurrent::promise<void> gate;
+            concurrent::future<void> opened = gate.get_future();
+            block_worker(obj, opened);
+            for (int i = 0; i < 10000; ++i)
+            {
+                obj.post([](int& value) -> void { ++value; });
+            }
+            concurrent::future<int> urgent = obj.call(concurrent::priority::urgent, [](int& value) -> int { return value; });
+            concurrent::future<int> bulk = obj <= ( [](int& value) -> int { return value; });
+            gate.set_value();
+            std::cout << name << ": urgent call saw " << urgent.get() << " of 10000 increments, bulk call saw " << bulk.get() << std::endl;
+        }
+
+        void test_priorities()
+        {
+            concurrent::async_object<int> threaded;
+            run_backlog(threaded, "Own thread");
+
+            concurrent::executor pool(1);
+            concurrent::async_object<int> stranded(pool);
+            run_backlog(stranded, "Executor");
+
+            concurrent::async_object<int> starving(pool);
+            concurrent::promise<void> gate;
+            concurrent::future<void> opened = gate.get_future();
+            block_worker(starving, opened);
+            for (int i = 0; i < 100; ++i)
+            {
+                starving.post(concurrent::priority::urgent, [](int& value) -> void { value += 1000; });
+            }
+            for (int i = 0; i < 3; ++i)
+            {
+                starving.post([](int& value) -> void { ++value; });
+            }
+            concurrent::future<int> last = starving.call(concurrent::priority::urgent, [](int& value) -> int { return value; });
+            gate.set_value();
+            std::cout << "Bulk functors run between 101 urgent ones: " << last.get() % 1000 << std::endl;
+        }
+
+        void test_instrumentation()
+        {
+            concurrent::async_object<int> obj;
+            concurrent::task_statistics before = obj.get_task_statistics();
+            if (!before.enabled)
+            {
+                std::cout << "Instrumentation disabled." << std::endl;
+                return;
+            }
+            concurrent::promise<void> gate;
+            concurrent::future<void> opened = gate.get_future();
+            block_worker(obj, opened);
+            for (int i = 0; i < 100; ++i)
+            {
+                obj.post([](int& value) -> void { ++value; });
+            }
+            std::uint64_t depth = obj.get_task_statistics().queue_depth();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            gate.set_value();
+            (obj <= ( [](int&) -> void { std::this_thread::sleep_for(std::chrono::milliseconds(2)); })).get();
+            concurrent::task_statistics after = obj.get_task_statistics();
+            std::cout << "Queue depth while blocked: " << depth << ", after: " << after.queue_depth() << ", completed: " << after.completed
+                      << ", timed (every " << CONCURRENT_INSTRUMENTATION_SAMPLING << "th): " << after.sojourn.total() << "/" << after.execution.total() << std::endl;
+            std::cout << "Max. sojourn >= 4 ms: " << std::boolalpha << (after.sojourn.percentile_ns(1.0) >= 4000000)
+                      << ", max. execution >= 2 ms: " << (after.execution.percentile_ns(1.0) >= 2000000)
+                      << ", tasks per second > 0: " << (after.tasks_per_second(before) > 0) << std::endl;
+
+            std::uint64_t exported = 0;
+            std::string lastName;
+            auto sink = [&exported, &lastName](const std::string& name, std::uint64_t) -> void { ++exported; lastName = name; };
+            after.export_to(sink, "obj");
+            std::cout << "Exported " << exported << " values, last: " << lastName << std::endl;
+        }
+
+        void test_readers()
+        {
+            concurrent::executor pool(4);
+            concurrent::async_object<std::vector<int>> obj(pool);
+            std::atomic<int> running(0);
+            std::atomic<int> maxRunning(0);
+            auto reader = [&running, &maxRunning](const std::vector<int>& v) -> std::size_t {
+                int now = ++running;
+                int seen = maxRunning.load();
+                while (now > seen && !maxRunning.compare_exchange_weak(seen, now)) {}
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --running;
+                return v.size();
+            };
+            std::vector<concurrent::future<std::size_t>> sizes;
+            auto start = std::chrono::steady_clock::now();
+            for (int round = 1; round <= 2; ++round)
+            {
+                obj <= ( [](std::vector<int>& v) -> void { v.push_back(static_cast<int>(v.size())); });
+                for (int i = 0; i < 8; ++i)
+                {
+                    sizes.push_back(obj <= reader);
+                }
+            }
+            std::size_t sum = 0;
+            for (auto& size : sizes)
+            {
+                sum += size.get();
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout << "Readers running at once: " << maxRunning.load() << ", sizes seen: " << sum << " (expected 24)"
+                      << ", faster than serial: " << std::boolalpha << (elapsed.count() < 16 * 20) << std::endl;
+
+            auto generic = concurrent::read_only([](const auto& v) -> std::size_t { return v.size(); });
+            std::cout << "Detected as read-only: " << concurrent::is_read_only<decltype(reader), std::vector<int>>::value << " "
+                      << concurrent::is_read_only<decltype(generic), std::vector<int>>::value << " "
+                      << concurrent::is_read_only<void (*)(std::vector<int>&), std::vector<int>>::value << ", generic: " << (obj <= generic).get() << std::endl;
+        }
+
         void main()
         {
             std::cout << "[:: Test 1: Call with no side effects. ::]" << std::endl;
@@ -149,6 +616,36 @@ namespace conc_test
 
             std::cout << "[:: Test 6: Move ctor stuff. ::]" << std::endl;
             test_move_ctor();
+
+            std::cout << "[:: Test 7: Many objects on a shared executor. ::]" << std::endl;
+            test_executor();
+
+            std::cout << "[:: Test 8: Allocation-free posting. ::]" << std::endl;
+            test_allocations();
+
+            std::cout << "[:: Test 9: Lightweight futures. ::]" << std::endl;
+            test_future();
+
+            std::cout << "[:: Test 10: Batched execution. ::]" << std::endl;
+            test_batches();
+
+            std::cout << "[:: Test 11: Fire-and-forget posts. ::]" << std::endl;
+            test_post();
+
+            std::cout << "[:: Test 12: Continuations. ::]" << std::endl;
+            test_continuations();
+
+            std::cout << "[:: Test 13: Coroutines. ::]" << std::endl;
+            test_coroutines();
+
+            std::cout << "[:: Test 14: Priority lanes. ::]" << std::endl;
+            test_priorities();
+
+            std::cout << "[:: Test 15: Instrumentation. ::]" << std::endl;
+            test_instrumentation();
+
+            std::cout << "[:: Test 16: Concurrent readers. ::]" << std::endl;
+            test_readers();
         }
     }
 }
@@ -2,11 +2,21 @@
 #define __TEST_CHANNEL_HPP__
 
 #include "concurrent/channel/channel.hpp"
+#include "concurrent/channel/select.hpp"
+#include "concurrent/storage/ring_buffer.hpp"
+#include "concurrent/lockfree/mpmc_ring.hpp"
+#include "concurrent/lockfree/spsc_ring.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace conc_test
 {
@@ -128,6 +138,343 @@ namespace conc_test
             t2.join();
         }
 
+        /**
+        Example 4: Create a bounded channel on top of a ring buffer. The producer is faster than the consumer,
+        so it gets blocked as soon as the buffer is full.
+        */
+        void Example4(std::uint32_t numRuns)
+        {
+            auto chan = concurrent::make_chan<int, concurrent::ring_buffer>(2);
+            std::mutex coutmutex;
+            std::thread t1([&chan, numRuns, &coutmutex]() -> void
+            {
+                std::uint32_t runs = numRuns;
+                int msgBase = 0;
+                while (runs-- > 0)
+                {
+                    chan << msgBase++;
+                }
+                std::lock_guard<std::mutex> guard(coutmutex);
+                std::cout << "Task 1 put all msgs." << std::endl;
+            });
+            std::thread t2([&chan, numRuns, &coutmutex]() -> void
+            {
+                int res = 0;
+                std::uint32_t runs = numRuns;
+                while (runs-- > 0)
+                {
+                    chan >> res;
+                    std::lock_guard<std::mutex> guard(coutmutex);
+                    std::cout << "Task 2 took a msg: " << res << std::endl;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            });
+            t1.join();
+            t2.join();
+
+            int filled = 0;
+            while (chan < filled)
+            {
+                ++filled;
+            }
+            std::cout << "Non-blocking put failed after " << filled << " msgs on a channel with capacity 2." << std::endl;
+        }
+
+        /**
+        Example 5: Same as example 4, but using the lock-free channel.
+        */
+        void Example5(std::uint32_t numRuns)
+        {
+            auto chan = concurrent::make_chan<int, concurrent::mpmc_ring>(2);
+            std::thread t1([&chan, numRuns]() -> void
+            {
+                std::uint32_t runs = numRuns;
+                int msgBase = 0;
+                while (runs-- > 0)
+                {
+                    chan << msgBase++;
+                }
+            });
+            int sum = 0;
+            int res = 0;
+            std::uint32_t runs = numRuns;
+            while (runs-- > 0)
+            {
+                chan >> res;
+                sum += res;
+            }
+            t1.join();
+            std::cout << "Sum of all msgs: " << sum << std::endl;
+            std::cout << "Non-blocking take on empty channel: " << std::boolalpha << (chan > res) << std::endl;
+        }
+
+        /**
+        Example 6: Directly instantiate a single-producer/single-consumer channel, like in example 1.
+        */
+        void Example6(std::uint32_t numRuns)
+        {
+            concurrent::channel<std::uint32_t, concurrent::spsc_ring> chan(16);
+            std::thread t1([&chan, numRuns]() -> void
+            {
+                for (std::uint32_t i = 0; i < numRuns; ++i)
+                {
+                    chan << i;
+                }
+            });
+            std::uint32_t res = 0;
+            std::uint32_t outOfOrder = 0;
+            for (std::uint32_t i = 0; i < numRuns; ++i)
+            {
+                chan >> res;
+                if (res != i) ++outOfOrder;
+            }
+            t1.join();
+            std::cout << "Received " << numRuns << " msgs, " << outOfOrder << " out of order." << std::endl;
+        }
+
+        /**
+        Example 7: Send batches through a chan and drain everything that is available at once.
+        */
+        void Example7(std::uint32_t numRuns)
+        {
+            auto chan = concurrent::make_chan<std::uint32_t>();
+            std::thread t1([&chan, numRuns]() -> void
+            {
+                std::vector<std::uint32_t> batch(8, 1);
+                for (std::uint32_t i = 0; i < numRuns; ++i)
+                {
+                    chan.push_bulk(batch);
+                }
+            });
+            std::vector<std::uint32_t> received;
+            std::uint32_t calls = 0;
+            while (received.size() < numRuns * 8)
+            {
+                chan.pop_bulk(std::back_inserter(received), numRuns * 8);
+                ++calls;
+            }
+            t1.join();
+            std::cout << "Received " << received.size() << " msgs within " << calls << " bulk calls." << std::endl;
+        }
+
+        /**
+        Example 8: Wait on two channels at once using select, until both of them got closed.
+        */
+        void Example8(std::uint32_t numRuns)
+        {
+            auto numbers = concurrent::make_chan<std::uint32_t>();
+            concurrent::channel<std::string, concurrent::mpmc_ring> words(4);
+            std::thread t1([&numbers, numRuns]() -> void
+            {
+                for (std::uint32_t i = 0; i < numRuns; ++i)
+                {
+                    numbers << i;
+                }
+                numbers.close();
+            });
+            std::thread t2([&words, numRuns]() -> void
+            {
+                for (std::uint32_t i = 0; i < numRuns; ++i)
+                {
+                    words << std::string("msg");
+                }
+                words.close();
+            });
+
+            std::uint32_t numbersReceived = 0;
+            std::uint32_t wordsReceived = 0;
+            concurrent::select sel;
+            sel.recv(numbers, [&numbersReceived](std::uint32_t) { ++numbersReceived; })
+               .recv(words, [&wordsReceived](std::string) { ++wordsReceived; });
+            while (sel.wait() != concurrent::select::npos) {}
+            t1.join();
+            t2.join();
+            std::cout << "Received " << numbersReceived << " numbers and " << wordsReceived << " words before both channels got closed." << std::endl;
+
+            std::uint32_t res = 0;
+            std::cout << "Receiving from closed channel yields end of stream: " << std::boolalpha << !(numbers >> res) << std::endl;
+            try
+            {
+                numbers << res;
+            }
+            catch (const concurrent::closed_channel_error& e)
+            {
+                std::cout << "Sending to closed channel: " << e.what() << std::endl;
+            }
+
+            concurrent::channel<std::uint32_t, concurrent::ring_buffer> bounded(1);
+            concurrent::select nonBlocking;
+            nonBlocking.send(bounded, 1u, []() { std::cout << "Sent via select." << std::endl; })
+                       .otherwise([]() { std::cout << "Channel full, took default case." << std::endl; });
+            nonBlocking.wait();
+            nonBlocking.wait();
+        }
+
+        /**
+        Example 9: Receive with a deadline, as a request handler with a latency budget would, and give up on a full channel.
+        */
+        template<typename Channel>
+        void Example9(Channel& ch)
+        {
+            std::uint32_t res = 0;
+            bool timedOut = ch.pop_for(res, std::chrono::milliseconds(10)) == concurrent::channel_status::not_ready;
+            std::cout << "pop_for on empty channel timed out: " << std::boolalpha << timedOut << std::endl;
+
+            std::thread t1([&ch]() -> void
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                ch << 42u;
+            });
+            concurrent::channel_status status = ch.pop_until(res, std::chrono::steady_clock::now() + std::chrono::seconds(5));
+            t1.join();
+            std::cout << "pop_until received msg " << res << ": " << (status == concurrent::channel_status::success) << std::endl;
+
+            while (ch.push_for(1u, std::chrono::milliseconds(5)) == concurrent::channel_status::success) {}
+            std::cout << "push_for gave up on full channel." << std::endl;
+            ch.close();
+            while (ch.pop_for(res, std::chrono::seconds(5)) == concurrent::channel_status::success) {}
+            std::cout << "pop_for reports closed channel: " << (ch.pop_for(res, std::chrono::seconds(5)) == concurrent::channel_status::closed) << std::endl;
+        }
+
+        /**
+        Example 10: Hand over move-only payloads, constructing some of them in place.
+        */
+        template<typename Channel>
+        void Example10(Channel& ch, std::uint32_t numRuns)
+        {
+            std::thread t1([&ch, numRuns]() -> void
+            {
+                for (std::uint32_t i = 0; i < numRuns; ++i)
+                {
+                    if (i % 2 == 0)
+                    {
+                        ch << std::unique_ptr<std::string>(new std::string("moved"));
+                    }
+                    else
+                    {
+                        ch.emplace(new std::string("emplaced"));
+                    }
+                }
+                ch.close();
+            });
+            std::unique_ptr<std::string> res;
+            std::size_t chars = 0;
+            while (ch >> res)
+            {
+                chars += res->size();
+            }
+            t1.join();
+            std::cout << "Received " << chars << " chars (expected " << (numRuns / 2) * 13 << ")." << std::endl;
+        }
+
+        /** \brief Message whose construction may throw, and does for the text "throw".
+         */
+        struct text_msg
+        {
+            text_msg() {}
+            explicit text_msg(std::string&& t) : text(std::move(t))
+            {
+                if (this->text == "throw")
+                {
+                    throw std::runtime_error("Cannot construct.");
+                }
+            }
+            text_msg(text_msg&& rhs) noexcept = default;
+            text_msg& operator=(text_msg&& rhs) noexcept = default;
+
+            std::string text;
+        };
+
+        /**
+        Example 11: Emplace into a full lock-free channel; the arguments may only be used once there is room. A constructor
+        that throws must neither lose nor block the msgs after it.
+        */
+        void Example11()
+        {
+            concurrent::channel<text_msg, concurrent::mpmc_ring> ch(2);
+            ch.emplace(std::string("first"));
+            ch.emplace(std::string("second"));
+            std::thread t1([&ch]() -> void
+            {
+                std::string text(100, 'x');
+                ch.emplace(std::move(text));
+                try
+                {
+                    ch.emplace(std::string("throw"));
+                }
+                catch (const std::runtime_error&)
+                {
+                    ch.emplace(std::string("after"));
+                }
+                ch.close();
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            text_msg msg;
+            std::vector<std::size_t> sizes;
+            while (ch >> msg)
+            {
+                sizes.push_back(msg.text.size());
+            }
+            t1.join();
+            std::cout << "Received sizes:";
+            for (std::size_t size : sizes)
+            {
+                std::cout << " " << size;
+            }
+            std::cout << " (expected 5 6 100 5)." << std::endl;
+        }
+
+        /**
+        Example 12: Close a lock-free channel while two threads keep sending; every msg a sender was told to be sent has to
+        reach the receiver before the end of the stream.
+        */
+        void Example12(std::uint32_t numRounds)
+        {
+            std::size_t lost = 0;
+            for (std::uint32_t round = 0; round < numRounds; ++round)
+            {
+                concurrent::channel<std::uint32_t, concurrent::mpmc_ring> ch(1024);
+                std::atomic<std::size_t> sent(0);
+                std::vector<std::thread> senders;
+                for (int t = 0; t < 2; ++t)
+                {
+                    senders.emplace_back([&ch, &sent]() -> void
+                    {
+                        for (std::uint32_t i = 0; i < 512; ++i)
+                        {
+                            concurrent::channel_status status = ch.try_send(i);
+                            if (status == concurrent::channel_status::closed)
+                            {
+                                return;
+                            }
+                            if (status == concurrent::channel_status::success)
+                            {
+                                ++sent;
+                            }
+                        }
+                    });
+                }
+                std::thread closer([&ch]() -> void
+                {
+                    std::this_thread::yield();
+                    ch.close();
+                });
+                std::size_t received = 0;
+                std::uint32_t msg;
+                while (ch >> msg)
+                {
+                    ++received;
+                }
+                closer.join();
+                for (auto& sender : senders)
+                {
+                    sender.join();
+                }
+                lost += sent.load() - received;
+            }
+            std::cout << "Msgs sent but not received in " << numRounds << " rounds: " << lost << std::endl;
+        }
+
         void main()
         {
             // Running test 1
@@ -144,6 +491,61 @@ namespace conc_test
             std::cout << "[Test 3] Instantiating channel and copy by default... " << std::endl;
             Example3(10);
             std::cout << "[Test 3] Completed. " << std::endl;
+
+            // Running test 4
+            std::cout << "[Test 4] Instantiating bounded channel... " << std::endl;
+            Example4(10);
+            std::cout << "[Test 4] Completed. " << std::endl;
+
+            // Running test 5
+            std::cout << "[Test 5] Instantiating lock-free channel... " << std::endl;
+            Example5(1000);
+            std::cout << "[Test 5] Completed. " << std::endl;
+
+            // Running test 6
+            std::cout << "[Test 6] Instantiating single-producer/single-consumer channel... " << std::endl;
+            Example6(100000);
+            std::cout << "[Test 6] Completed. " << std::endl;
+
+            // Running test 7
+            std::cout << "[Test 7] Sending and receiving msgs in bulk... " << std::endl;
+            Example7(100);
+            std::cout << "[Test 7] Completed. " << std::endl;
+
+            // Running test 8
+            std::cout << "[Test 8] Closing channels and selecting over several of them... " << std::endl;
+            Example8(1000);
+            std::cout << "[Test 8] Completed. " << std::endl;
+
+            // Running test 9
+            std::cout << "[Test 9] Timed send and receive on bounded, lock-free and SPSC channels... " << std::endl;
+            concurrent::channel<std::uint32_t, concurrent::ring_buffer> bounded(4);
+            Example9(bounded);
+            auto lockfree = concurrent::make_chan<std::uint32_t, concurrent::mpmc_ring>(4);
+            Example9(lockfree);
+            concurrent::channel<std::uint32_t, concurrent::spsc_ring> spsc(4);
+            Example9(spsc);
+            std::cout << "[Test 9] Completed. " << std::endl;
+
+            // Running test 10
+            std::cout << "[Test 10] Sending move-only msgs... " << std::endl;
+            auto moveOnly = concurrent::make_chan<std::unique_ptr<std::string>>();
+            Example10(moveOnly, 100);
+            concurrent::channel<std::unique_ptr<std::string>, concurrent::ring_buffer> boundedMoveOnly(4);
+            Example10(boundedMoveOnly, 100);
+            concurrent::channel<std::unique_ptr<std::string>, concurrent::spsc_ring> spscMoveOnly(4);
+            Example10(spscMoveOnly, 100);
+            std::cout << "[Test 10] Completed. " << std::endl;
+
+            // Running test 11
+            std::cout << "[Test 11] Emplacing into a full lock-free channel... " << std::endl;
+            Example11();
+            std::cout << "[Test 11] Completed. " << std::endl;
+
+            // Running test 12
+            std::cout << "[Test 12] Closing a lock-free channel while sending... " << std::endl;
+            Example12(200);
+            std::cout << "[Test 12] Completed. " << std::endl;
         }
     }
 }
@@ -0,0 +1,370 @@
+#ifndef __TEST_QUEUE_HPP__
+#define __TEST_QUEUE_HPP__
+
+#include "concurrent/queue.hpp"
+#include "concurrent/storage/ring_buffer.hpp"
+#include "concurrent/lockfree/mpmc_ring.hpp"
+#include "concurrent/storage/pool_resource.hpp"
+#include "concurrent/storage/priority_lanes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace conc_test
+{
+    namespace queues
+    {
+        void test_simple()
+        {
+            concurrent::queue<int> q;
+            q.push(1).push(2).push(3);
+            std::cout << q.pop() << " " << q.pop() << " " << q.pop() << std::endl;
+        }
+
+        void test_bounded()
+        {
+            concurrent::queue<int, concurrent::ring_buffer> q(3);
+            std::uint32_t accepted = 0;
+            for (int i = 0; i < 5; ++i)
+            {
+                if (q.try_push(i)) ++accepted;
+            }
+            std::cout << "try_push accepted " << accepted << " of 5 msgs (capacity 3)." << std::endl;
+
+            // The producer gets blocked until the consumer below makes room.
+            std::thread producer([&q]() -> void
+            {
+                for (int i = 3; i < 10; ++i)
+                {
+                    q.push(i);
+                }
+            });
+            int sum = 0;
+            for (int i = 0; i < 10; ++i)
+            {
+                sum += q.pop();
+            }
+            producer.join();
+            std::cout << "Sum of all msgs: " << sum << " (expected 45)" << std::endl;
+
+            q.push(42);
+            q.clear();
+            std::cout << "Accepts msgs after clear(): " << std::boolalpha << q.try_push(1) << std::endl;
+
+            concurrent::ring_buffer<int> buffer(2);
+            buffer.push(7);
+            concurrent::ring_buffer<int> taken(std::move(buffer));
+            std::cout << "Moved-from buffer is full: " << buffer.full() << ", capacity: " << buffer.capacity()
+                      << ", moved-to front: " << taken.front() << std::endl;
+        }
+
+        void test_lockfree()
+        {
+            // Small capacity to make producers and consumers block on each other regularly.
+            concurrent::queue<std::uint64_t, concurrent::mpmc_ring> q(8);
+            const std::uint64_t perThread = 10000;
+            std::atomic<std::uint64_t> sum(0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back([&q, perThread]() -> void
+                {
+                    for (std::uint64_t i = 1; i <= perThread; ++i)
+                    {
+                        q.push(i);
+                    }
+                });
+                threads.emplace_back([&q, &sum, perThread]() -> void
+                {
+                    for (std::uint64_t i = 0; i < perThread; ++i)
+                    {
+                        sum += q.pop();
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            std::cout << "Sum of all msgs: " << sum << " (expected " << 4 * perThread * (perThread + 1) / 2 << ")" << std::endl;
+
+            std::uint32_t accepted = 0;
+            for (std::uint64_t i = 0; i < 10; ++i)
+            {
+                if (q.try_push(i)) ++accepted;
+            }
+            std::cout << "try_push accepted " << accepted << " of 10 msgs (capacity 8)." << std::endl;
+        }
+
+        template<typename Queue>
+        void test_bulk(Queue& q)
+        {
+            std::vector<int> batch;
+            for (int i = 0; i < 100; ++i)
+            {
+                batch.push_back(i);
+            }
+            std::thread producer([&q, &batch]() -> void
+            {
+                q.push_bulk(batch);
+                q.push_bulk(batch.begin(), batch.begin() + 10);
+            });
+            std::vector<int> received;
+            while (received.size() < 110)
+            {
+                q.pop_bulk(std::back_inserter(received), 32);
+            }
+            producer.join();
+            std::cout << "Received " << received.size() << " msgs, last one: " << received.back()
+                      << ", nothing left to drain: " << std::boolalpha << (q.drain_into(received) == 0) << std::endl;
+        }
+
+        template<typename Queue>
+        void test_timed(Queue& q)
+        {
+            int msg = 0;
+            auto start = std::chrono::steady_clock::now();
+            bool gotMsg = q.pop_for(msg, std::chrono::milliseconds(20));
+            auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout << "pop_for on empty queue: " << std::boolalpha << gotMsg << ", waited at least 20ms: " << (waited.count() >= 20) << std::endl;
+
+            std::thread producer([&q]() -> void
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                q.push(7);
+            });
+            gotMsg = q.pop_until(msg, std::chrono::steady_clock::now() + std::chrono::seconds(5));
+            producer.join();
+            std::cout << "pop_until got msg in time: " << gotMsg << ", msg: " << msg << std::endl;
+
+            std::uint32_t accepted = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (q.push_for(i, std::chrono::milliseconds(5))) ++accepted;
+            }
+            std::cout << "push_for accepted " << accepted << " of 4 msgs." << std::endl;
+            std::vector<int> rest;
+            q.drain_into(rest);
+        }
+
+        template<typename Queue>
+        void test_move_only(Queue& q)
+        {
+            std::unique_ptr<int> payload(new int(1));
+            const int* address = payload.get();
+            q.push(std::move(payload));
+            q.emplace(new int(2));
+            std::unique_ptr<int> first = q.pop();
+            std::unique_ptr<int> second = q.pop();
+            std::cout << "Moved msgs: " << *first << " " << *second
+                      << ", payload was not copied: " << std::boolalpha << (first.get() == address) << std::endl;
+        }
+
+        template<typename Queue>
+        void test_wait_strategy(Queue& q, const concurrent::wait_strategy& strategy)
+        {
+            q.set_wait_strategy(strategy);
+            std::thread producer([&q]() -> void
+            {
+                for (int i = 1; i <= 10000; ++i)
+                {
+                    q.push(i);
+                }
+            });
+            long long sum = 0;
+            for (int i = 0; i < 10000; ++i)
+            {
+                sum += q.pop();
+            }
+            producer.join();
+            std::cout << "Spins: " << q.get_wait_strategy().spin_count << ", sum of all msgs: " << sum << " (expected 50005000)" << std::endl;
+        }
+
+#ifdef CONCURRENT_HAS_PMR
+        void test_pool()
+        {
+            concurrent::pool_resource pool;
+            concurrent::queue<int, concurrent::pmr::deque_storage> q(std::allocator_arg, &pool);
+            for (int round = 0; round < 10; ++round)
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    q.push(i);
+                }
+                if (round % 2 == 0)
+                {
+                    q.clear();
+                }
+                else
+                {
+                    std::vector<int> received;
+                    q.drain_into(received);
+                }
+            }
+            std::size_t warmedUp = pool.stats().upstream_allocations;
+            for (int round = 0; round < 100; ++round)
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    q.push(i);
+                }
+                for (int i = 0; i < 1000; ++i)
+                {
+                    q.pop();
+                }
+            }
+            concurrent::memory_stats stats = pool.stats();
+            std::cout << "No upstream allocations in steady state: " << std::boolalpha << (stats.upstream_allocations == warmedUp)
+                      << ", in use when empty: " << stats.bytes_in_use << " bytes, peak: " << stats.peak_bytes_in_use
+                      << " bytes, reserved: " << stats.bytes_reserved << " bytes" << std::endl;
+
+            concurrent::pool_resource ringPool;
+            concurrent::queue<std::uint64_t, concurrent::pmr::ring_buffer> bounded(std::allocator_arg, &ringPool, 128);
+            bounded.push(1);
+            std::cout << "Ring buffer slots taken from pool: " << ringPool.stats().bytes_in_use << " bytes" << std::endl;
+        }
+#endif
+
+        void test_priority_lanes()
+        {
+            concurrent::queue<int, concurrent::priority_lanes> q;
+            for (int i = 0; i < 5; ++i)
+            {
+                q.push(100 + i);
+            }
+            for (int i = 0; i < 40; ++i)
+            {
+                q.emplace(concurrent::priority::urgent, i);
+            }
+            std::vector<int> received;
+            q.drain_into(received);
+            std::cout << "Order (bulk >= 100, one after every 16 urgent):";
+            for (int msg : received)
+            {
+                if (msg >= 100)
+                {
+                    std::cout << " [" << msg << "]";
+                }
+                else if (msg % 8 == 0)
+                {
+                    std::cout << " " << msg;
+                }
+            }
+            std::cout << std::endl;
+        }
+
+        /** \brief Message whose construction may throw, and does for the text "throw".
+         */
+        struct text_msg
+        {
+            text_msg() {}
+            explicit text_msg(std::string&& t) : text(std::move(t))
+            {
+                if (this->text == "throw")
+                {
+                    throw std::runtime_error("Cannot construct.");
+                }
+            }
+            text_msg(text_msg&& rhs) noexcept = default;
+            text_msg& operator=(text_msg&& rhs) noexcept = default;
+
+            std::string text;
+        };
+
+        /** \brief Emplaces into a full lock-free queue, which has to wait for room before it uses the arguments, then lets a
+         *         constructor throw, which must neither lose nor block later messages.
+         */
+        void test_emplace_full()
+        {
+            concurrent::queue<text_msg, concurrent::mpmc_ring> q(2);
+            q.emplace(std::string("first"));
+            q.emplace(std::string("second"));
+            std::thread producer([&q]() -> void {
+                std::string text(100, 'x');
+                q.emplace(std::move(text));
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::string first = q.pop().text;
+            producer.join();
+            std::string second = q.pop().text;
+            std::size_t waited = q.pop().text.size();
+            bool thrown = false;
+            try
+            {
+                q.emplace(std::string("throw"));
+            }
+            catch (const std::runtime_error&)
+            {
+                thrown = true;
+            }
+            q.emplace(std::string("after")); // The failed slot still takes up room until a consumer passes it.
+            std::string after = q.pop().text;
+            q.emplace(std::string("last"));
+            std::string last = q.pop().text;
+            std::cout << first << " " << second << ", waiting msg size: " << waited << ", thrown: " << std::boolalpha << thrown
+                      << ", then: " << after << " " << last << std::endl;
+        }
+
+        void main()
+        {
+            std::cout << "[:: Test 1: Unbounded queue. ::]" << std::endl;
+            test_simple();
+
+            std::cout << "[:: Test 2: Bounded queue on ring buffer. ::]" << std::endl;
+            test_bounded();
+
+            std::cout << "[:: Test 3: Lock-free queue. ::]" << std::endl;
+            test_lockfree();
+
+            std::cout << "[:: Test 4: Bulk push and pop. ::]" << std::endl;
+            concurrent::queue<int> unbounded;
+            test_bulk(unbounded);
+            concurrent::queue<int, concurrent::ring_buffer> bounded(16);
+            test_bulk(bounded);
+            concurrent::queue<int, concurrent::mpmc_ring> lockfree(16);
+            test_bulk(lockfree);
+
+            std::cout << "[:: Test 5: Timed push and pop (unbounded, capacity 2, lock-free capacity 2). ::]" << std::endl;
+            test_timed(unbounded);
+            concurrent::queue<int, concurrent::ring_buffer> bounded2(2);
+            test_timed(bounded2);
+            concurrent::queue<int, concurrent::mpmc_ring> lockfree2(2);
+            test_timed(lockfree2);
+
+            std::cout << "[:: Test 6: Move-only msgs and emplace. ::]" << std::endl;
+            concurrent::queue<std::unique_ptr<int>> unboundedMoveOnly;
+            test_move_only(unboundedMoveOnly);
+            concurrent::queue<std::unique_ptr<int>, concurrent::ring_buffer> boundedMoveOnly(2);
+            test_move_only(boundedMoveOnly);
+            concurrent::queue<std::unique_ptr<int>, concurrent::mpmc_ring> lockfreeMoveOnly(2);
+            test_move_only(lockfreeMoveOnly);
+
+            std::cout << "[:: Test 7: Wait strategies. ::]" << std::endl;
+            test_wait_strategy(bounded2, concurrent::wait_strategy::cpu_friendly());
+            test_wait_strategy(bounded2, concurrent::wait_strategy::latency_optimized());
+            test_wait_strategy(lockfree2, concurrent::wait_strategy::cpu_friendly());
+            test_wait_strategy(lockfree2, concurrent::wait_strategy::latency_optimized());
+
+#ifdef CONCURRENT_HAS_PMR
+            std::cout << "[:: Test 8: Storage on a memory pool. ::]" << std::endl;
+            test_pool();
+#endif
+
+            std::cout << "[:: Test 9: Priority lanes. ::]" << std::endl;
+            test_priority_lanes();
+
+            std::cout << "[:: Test 10: Emplace into a full lock-free queue. ::]" << std::endl;
+            test_emplace_full();
+        }
+    }
+}
+
+#endif // __TEST_QUEUE_HPP__
@@ -1,10 +1,24 @@
 #ifndef __TEST_SYNC_OBJ_HPP__
 #define __TEST_SYNC_OBJ_HPP__
 
+#include "concurrent/reader_biased_lock.hpp"
+#include "concurrent/sharded_sync_object.hpp"
 #include "concurrent/sync_object.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<shared_mutex>)
+#include <shared_mutex>
+#endif
+#endif
 
 namespace conc_test
 {
@@ -104,6 +118,238 @@ namespace conc_test
             blub <= foo_functor();
         }
 
+        struct pair_of_counters
+        {
+            int first;
+            int second;
+        };
+
+        /** \brief Four threads read a pair of counters 99 times for each time they increment both, and check that they never
+         *         see them differ. Afterwards, two slow readers check that they ran at the same time.
+         */
+        template<typename Lock>
+        void test_readers_writers(const char* name)
+        {
+            concurrent::sync_object<pair_of_counters, Lock> counters(pair_of_counters{ 0, 0 });
+            std::atomic<int> torn(0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back([&counters, &torn]() -> void {
+                    for (int i = 0; i < 10000; ++i)
+                    {
+                        if (i % 100 == 0)
+                        {
+                            counters <= [](pair_of_counters& c) -> void { ++c.first; ++c.second; };
+                        }
+                        else if (!(counters <= [](const pair_of_counters& c) -> bool { return c.first == c.second; }).get())
+                        {
+                            ++torn;
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            int total = (counters <= [](const pair_of_counters& c) -> int { return c.first; }).get();
+
+            std::atomic<int> inside(0);
+            std::atomic<int> maxInside(0);
+            auto slowReader = [&inside, &maxInside](const pair_of_counters&) -> void {
+                int now = ++inside;
+                int seen = maxInside.load();
+                while (now > seen && !maxInside.compare_exchange_weak(seen, now)) {}
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --inside;
+            };
+            std::thread other([&counters, &slowReader]() -> void { counters <= slowReader; });
+            counters <= slowReader;
+            other.join();
+            std::cout << name << ": " << total << " increments, torn reads: " << torn.load() << ", readers at once: " << maxInside.load() << std::endl;
+        }
+
+        /** \brief Eight threads increment a counter through a flat-combining sync_object, and check that every call got a
+         *         value of its own. Afterwards, an exception thrown by one functor has to reach its caller only.
+         */
+        void test_flat_combining()
+        {
+            concurrent::sync_object<long, concurrent::flat_combining> counter(0);
+            std::vector<std::vector<long>> seen(8);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 8; ++t)
+            {
+                threads.emplace_back([&counter, &seen, t]() -> void {
+                    for (int i = 0; i < 10000; ++i)
+                    {
+                        seen[t].push_back((counter <= [](long& c) -> long { return ++c; }).get());
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            std::vector<bool> taken(80001, false);
+            int duplicates = 0;
+            for (const auto& values : seen)
+            {
+                for (long value : values)
+                {
+                    duplicates += (value < 1 || value > 80000 || taken[value]) ? 1 : 0;
+                    if (value >= 1 && value <= 80000)
+                    {
+                        taken[value] = true;
+                    }
+                }
+            }
+            long total = (counter <= [](const long& c) -> long { return c; }).get();
+            std::cout << "Counter: " << total << ", duplicate or invalid results: " << duplicates << std::endl;
+
+            auto failed = counter <= [](long&) -> long { throw std::runtime_error("Failed on purpose."); };
+            try
+            {
+                failed.get();
+                std::cout << "No exception received." << std::endl;
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cout << "Exception received: " << e.what() << std::endl;
+            }
+            concurrent::sync_object<long, concurrent::flat_combining> copy(counter);
+            std::cout << "Copy: " << (copy <= [](const long& c) -> long { return c; }).get() << std::endl;
+        }
+
+        /** \brief Four threads count disjoint keys in a sharded map, then the shard sizes are summed up under all locks.
+         *         Afterwards, an exception thrown for one key has to reach its caller only.
+         */
+        void test_sharded()
+        {
+            typedef std::unordered_map<int, int> map_type;
+            concurrent::sharded_sync_object<map_type> counts(8);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+            {
+                threads.emplace_back([&counts, t]() -> void {
+                    for (int i = 0; i < 20000; ++i)
+                    {
+                        int key = t * 1000 + i % 1000;
+                        counts[key] <= [key](map_type& shard) -> void { ++shard[key]; };
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            auto keys = counts <= [](concurrent::shard_range<map_type>& shards) -> std::size_t {
+                std::size_t sum = 0;
+                for (auto& shard : shards)
+                {
+                    sum += shard.size();
+                }
+                return sum;
+            };
+            auto count = counts[2500] <= [](const map_type& shard) -> int { return shard.at(2500); };
+            std::cout << "Shards: " << counts.shards() << ", keys: " << keys.get() << ", count of key 2500: " << count.get() << std::endl;
+
+            auto missing = counts[4711] <= [](const map_type& shard) -> int { return shard.at(4711); };
+            try
+            {
+                missing.get();
+                std::cout << "No exception received." << std::endl;
+            }
+            catch (const std::out_of_range&)
+            {
+                std::cout << "Exception received for a missing key." << std::endl;
+            }
+        }
+
+        struct price_tick
+        {
+            price_tick(int i, double p) : id(i), price(p) {}
+
+            int id;
+            double price;
+        };
+
+        /** \brief One thread keeps incrementing both counters of a pair while three threads read it without locking, and check
+         *         that they never see the counters differ.
+         */
+        void test_seqlock()
+        {
+            concurrent::sync_object<pair_of_counters, concurrent::seqlock> counters(pair_of_counters{ 0, 0 });
+            std::atomic<bool> writing(true);
+            std::atomic<int> torn(0);
+            std::atomic<int> reads(0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 3; ++t)
+            {
+                threads.emplace_back([&counters, &writing, &torn, &reads]() -> void {
+                    while (writing.load())
+                    {
+                        if (!(counters <= [](const pair_of_counters& c) -> bool { return c.first == c.second; }).get())
+                        {
+                            ++torn;
+                        }
+                        ++reads;
+                    }
+                });
+            }
+            for (int i = 0; i < 100000; ++i)
+            {
+                counters <= [](pair_of_counters& c) -> void { ++c.first; ++c.second; };
+            }
+            writing.store(false);
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            concurrent::sync_object<pair_of_counters, concurrent::seqlock> copy(counters);
+            int total = (copy <= [](const pair_of_counters& c) -> int { return c.second; }).get();
+            std::cout << "Seqlock: " << total << " increments, torn reads: " << torn.load() << (reads.load() > 0 ? "" : ", no reads!") << std::endl;
+
+            concurrent::sync_object<price_tick, concurrent::seqlock> tick(price_tick(42, 1.5));
+            tick <= [](price_tick& t) -> void { t.price *= 2; };
+            std::cout << "Tick without default c'tor: " << (tick <= [](const price_tick& t) -> double { return t.id + t.price; }).get() << std::endl;
+        }
+
+        /** \brief Two threads move money between two accounts in opposite directions, which deadlocks with nested calls.
+         *         Afterwards, the total has to be unchanged, and a failed transfer has to report its exception.
+         */
+        void test_sync_apply()
+        {
+            concurrent::sync_object<int> first(1000);
+            concurrent::sync_object<int, concurrent::reader_biased_lock> second(1000);
+            auto transfer = [](int& from, int& to) -> void { from -= 1; to += 1; };
+            std::thread forth([&]() -> void {
+                for (int i = 0; i < 20000; ++i)
+                {
+                    concurrent::sync_apply(transfer, first, second);
+                }
+            });
+            std::thread back([&]() -> void {
+                for (int i = 0; i < 20000; ++i)
+                {
+                    concurrent::sync_apply([&transfer](int& to, int& from) -> void { transfer(from, to); }, first, second);
+                }
+            });
+            forth.join();
+            back.join();
+            int total = concurrent::sync_apply([](int& a, int& b) -> int { return a + b; }, second, first).get();
+            int twice = concurrent::sync_apply([](int& a, int& b) -> int { return &a == &b ? 1 : 0; }, first, first).get();
+            std::cout << "Total: " << total << ", same object given twice: " << (twice == 1 ? "locked once" : "wrong") << std::endl;
+
+            auto overdrawn = concurrent::sync_apply([](int& from, int&) -> void {
+                if (from < 5000)
+                {
+                    throw std::runtime_error("Insufficient funds.");
+                }
+            }, first, second);
+            std::cout << (overdrawn.hasException<std::runtime_error>() ? "Exception received." : "No exception received.") << std::endl;
+        }
+
         void main()
         {
             std::cout << "[:: Test 1: Call with no side effects. ::]" << std::endl;
@@ -123,6 +369,24 @@ namespace conc_test
 
             std::cout << "[:: Test 6: Move ctor stuff. ::]" << std::endl;
             test_move_ctor();
+
+            std::cout << "[:: Test 7: Readers and writers. ::]" << std::endl;
+            test_readers_writers<concurrent::reader_biased_lock>("Reader-biased lock");
+#if defined(__cpp_lib_shared_mutex)
+            test_readers_writers<std::shared_mutex>("std::shared_mutex");
+#endif
+
+            std::cout << "[:: Test 8: Flat combining. ::]" << std::endl;
+            test_flat_combining();
+
+            std::cout << "[:: Test 9: Sharded map. ::]" << std::endl;
+            test_sharded();
+
+            std::cout << "[:: Test 10: Sequence lock. ::]" << std::endl;
+            test_seqlock();
+
+            std::cout << "[:: Test 11: Atomic operations on several objects. ::]" << std::endl;
+            test_sync_apply();
         }
     }
 }
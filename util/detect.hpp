@@ -11,6 +11,53 @@ namespace detect
         template<typename U> static int Test(...);
         static const bool value = sizeof(Test<T>(0)) == sizeof(char);
     };
+
+    template<typename T>
+    struct has_member_full
+    {
+        template<typename U, bool (U::*)() const> struct SFINAE {}; // Signature of a bounded storage's full-check is bool full() const
+        template<typename U> static char Test(SFINAE<U, &U::full>*);
+        template<typename U> static int Test(...);
+        static const bool value = sizeof(Test<T>(0)) == sizeof(char);
+    };
+
+    template<typename T>
+    struct has_member_lock_shared
+    {
+        template<typename U, void (U::*)()> struct SFINAE {}; // Signature of a shared lock's lock_shared is void lock_shared()
+        template<typename U> static char Test(SFINAE<U, &U::lock_shared>*);
+        template<typename U> static int Test(...);
+        static const bool value = sizeof(Test<T>(0)) == sizeof(char);
+    };
+
+    /** \brief Checks whether F is a functor or function whose only parameter is a const T&, i.e. one that cannot modify the
+     *         T it is called with. Generic lambdas and overloaded call operators are not recognized.
+     */
+    template<typename F, typename T>
+    struct is_read_only_functor
+    {
+        template<typename R, typename U> static char Check(R (U::*)(const T&) const);
+        template<typename R, typename U> static char Check(R (U::*)(const T&));
+        static int Check(...);
+        template<typename U> static decltype(Check(&U::operator())) Test(int);
+        template<typename U> static int Test(...);
+        static const bool value = sizeof(Test<F>(0)) == sizeof(char);
+    };
+
+    template<typename R, typename T>
+    struct is_read_only_functor<R (*)(const T&), T>
+    {
+        static const bool value = true;
+    };
+
+    template<typename T>
+    struct has_member_clear
+    {
+        template<typename U, void (U::*)()> struct SFINAE {}; // Signature of member clear regularly is void clear()
+        template<typename U> static char Test(SFINAE<U, &U::clear>*);
+        template<typename U> static int Test(...);
+        static const bool value = sizeof(Test<T>(0)) == sizeof(char);
+    };
 }
 
 
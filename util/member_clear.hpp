@@ -0,0 +1,30 @@
+#ifndef __UTIL_MEMBER_CLEAR_HPP__
+#define __UTIL_MEMBER_CLEAR_HPP__
+
+/** \brief Storage without a clear() member gets drained using the queue policy (pop(), empty() ). Unlike swapping it with a
+ *         freshly constructed one, this keeps the storage's allocator, e.g. a polymorphic allocator bound to a memory pool.
+ */
+template<bool, typename T>
+struct if_member_clear
+{
+    static void exec(T& storage)
+    {
+        while (!storage.empty())
+        {
+            storage.pop();
+        }
+    }
+};
+
+/** \brief Storage with a clear() member keeps its (possibly preallocated) memory and only drops its content.
+ */
+template<typename T>
+struct if_member_clear<true, T>
+{
+    static void exec(T& storage)
+    {
+        storage.clear();
+    }
+};
+
+#endif // __UTIL_MEMBER_CLEAR_HPP__
@@ -0,0 +1,24 @@
+#ifndef __UTIL_MEMBER_FULL_HPP__
+#define __UTIL_MEMBER_FULL_HPP__
+
+/** \brief Storage without a full() member is considered to be unbounded, thus it is never full.
+ */
+template<bool, typename T>
+struct if_member_full
+{
+    static bool exec(const T& /*storage*/)
+    {
+        return false;
+    }
+};
+
+template<typename T>
+struct if_member_full<true, T>
+{
+    static bool exec(const T& storage)
+    {
+        return storage.full();
+    }
+};
+
+#endif // __UTIL_MEMBER_FULL_HPP__